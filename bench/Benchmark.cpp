@@ -0,0 +1,304 @@
+#include <iostream>
+#include <fstream>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include <algorithm>
+#include <omp.h>
+
+#include "../lab1/ColumnMax.h"
+#include "../lab2/DiagonalMax.h"
+#include "../lab3/Integration.h"
+#include "../lab4/Trapezoidal.h"
+#include "../lab5/Vowels.h"
+
+using namespace std;
+
+// Общий замер ядер всех пяти программ.
+//
+// Для каждого ядра, множителя размера и числа нитей p выполняются прогревочные
+// запуски и затем повторения с замером времени (steady_clock). По повторениям
+// считаются медиана и 95-й перцентиль. Сильная масштабируемость — размер задачи
+// фиксирован, эффективность T(p0) * p0 / (p * T(p)); слабая — размер растёт
+// пропорционально p, эффективность T(p0) / T(p) (p0 — наименьшее число нитей в списке).
+// Результаты печатаются таблицей и при необходимости пишутся в CSV/JSON.
+
+// Подготовленный запуск: данные уже созданы, run() возвращает контрольное значение
+using Runner = function<double()>;
+
+struct Kernel {
+    string name;
+    long long baseSize;  // размер при множителе 1
+    function<Runner(long long size)> prepare;
+};
+
+struct Options {
+    vector<int> threads;
+    vector<long long> scales = {1};
+    int repetitions = 10;
+    int warmup = 2;
+    vector<string> kernels;
+    string csvPath;
+    string jsonPath;
+};
+
+struct Record {
+    string kernel;
+    string mode;  // strong / weak
+    int threads;
+    long long size;
+    double medianMs;
+    double p95Ms;
+    double minMs;
+    double efficiency;
+    double checksum;
+};
+
+// --- Ядра ---
+
+vector<vector<int>> randomMatrix(long long rows, long long cols, unsigned seed) {
+    minstd_rand rng(seed);
+    vector<vector<int>> matrix(rows, vector<int>(cols));
+    for (auto& row : matrix) {
+        for (int& x : row) x = rng() % 1000;
+    }
+    return matrix;
+}
+
+vector<Kernel> makeKernels() {
+    vector<Kernel> kernels;
+
+    // lab1: максимумы столбцов, матрица size / 1024 x 1024
+    kernels.push_back({"columns", 1LL << 22, [](long long size) -> Runner {
+        const long long cols = 1024;
+        auto matrix = make_shared<vector<vector<int>>>(randomMatrix(max(1LL, size / cols), cols, 1));
+        return [matrix] {
+            vector<int> maxima = findMaxInColumnsParallel(*matrix);
+            double sum = 0;
+            for (int x : maxima) sum += x;
+            return sum;
+        };
+    }});
+
+    // lab2: максимумы всех побочных диагоналей квадратной матрицы из size элементов
+    kernels.push_back({"diagonals", 1LL << 22, [](long long size) -> Runner {
+        long long n = max(1LL, (long long)sqrt((double)size));
+        auto matrix = make_shared<vector<vector<int>>>(randomMatrix(n, n, 2));
+        return [matrix] {
+            vector<int> maxima = findMaxOnDiagonalsParallel(*matrix);
+            double sum = 0;
+            for (int x : maxima) sum += x;
+            return sum;
+        };
+    }});
+
+    // lab3: интеграл sin(x) на [0, 1] из size отрезков
+    kernels.push_back({"integrate", 1LL << 24, [](long long size) -> Runner {
+        return [size] { return integrateParallel(0.0, 1.0, size, "sin(x)"); };
+    }});
+
+    // lab4: метод трапеций для ряда f(x, epsilon) на [0, 1]
+    kernels.push_back({"trapezoid", 1LL << 16, [](long long size) -> Runner {
+        return [size] { return trapezoidal_rule_par(0.0, 1.0, size, 1e-6); };
+    }});
+
+    // lab5: поиск гласных в тексте из size байт (строки по 80 символов, без 'u')
+    kernels.push_back({"vowels", 1LL << 23, [](long long size) -> Runner {
+        const long long lineLength = 80;
+        const string alphabet = "abcdefghijklmnopqrstvwxyz ";
+        minstd_rand rng(5);
+        auto text = make_shared<vector<string>>(max(1LL, size / lineLength), string(lineLength, ' '));
+        for (auto& line : *text) {
+            for (char& c : line) c = alphabet[rng() % alphabet.size()];
+        }
+        auto vowels = make_shared<unordered_set<char>>(getEnglishVowels());
+        return [text, vowels] { return (double)findMissingVowelsParallel(*text, *vowels).size(); };
+    }});
+
+    return kernels;
+}
+
+// --- Замер ---
+
+double percentile(vector<double> samples, double q) {
+    sort(samples.begin(), samples.end());
+    // Ближайший ранг: наименьшее значение, не меньше которого доля q выборки
+    size_t rank = (size_t)ceil(q * samples.size());
+    return samples[min(samples.size(), max<size_t>(rank, 1)) - 1];
+}
+
+Record measure(const Kernel& kernel, const string& mode, int threads, long long size, const Options& options) {
+    omp_set_num_threads(threads);
+    Runner run = kernel.prepare(size);
+
+    double checksum = 0;
+    for (int i = 0; i < options.warmup; ++i) checksum = run();
+
+    vector<double> samples;
+    for (int i = 0; i < options.repetitions; ++i) {
+        auto start = chrono::steady_clock::now();
+        checksum = run();
+        auto end = chrono::steady_clock::now();
+        samples.push_back(chrono::duration<double, milli>(end - start).count());
+    }
+
+    Record record{kernel.name, mode, threads, size, 0, 0, 0, 0, checksum};
+    record.medianMs = percentile(samples, 0.5);
+    record.p95Ms = percentile(samples, 0.95);
+    record.minMs = *min_element(samples.begin(), samples.end());
+    return record;
+}
+
+// --- Вывод ---
+
+void writeCsv(const string& path, const vector<Record>& records) {
+    ofstream out(path);
+    if (!out) throw runtime_error("Cannot open file: " + path);
+    out << "kernel,mode,threads,size,median_ms,p95_ms,min_ms,efficiency,checksum\n";
+    out.precision(17);
+    for (const auto& r : records) {
+        out << r.kernel << ',' << r.mode << ',' << r.threads << ',' << r.size << ',' << r.medianMs << ','
+            << r.p95Ms << ',' << r.minMs << ',' << r.efficiency << ',' << r.checksum << '\n';
+    }
+}
+
+void writeJson(const string& path, const vector<Record>& records, const Options& options) {
+    ofstream out(path);
+    if (!out) throw runtime_error("Cannot open file: " + path);
+    out.precision(17);
+    out << "{\n  \"repetitions\": " << options.repetitions << ",\n  \"warmup\": " << options.warmup
+        << ",\n  \"max_threads\": " << omp_get_num_procs() << ",\n  \"results\": [\n";
+    for (size_t i = 0; i < records.size(); ++i) {
+        const auto& r = records[i];
+        out << "    {\"kernel\": \"" << r.kernel << "\", \"mode\": \"" << r.mode << "\", \"threads\": " << r.threads
+            << ", \"size\": " << r.size << ", \"median_ms\": " << r.medianMs << ", \"p95_ms\": " << r.p95Ms
+            << ", \"min_ms\": " << r.minMs << ", \"efficiency\": " << r.efficiency
+            << ", \"checksum\": " << r.checksum << "}" << (i + 1 < records.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+}
+
+// --- Разбор аргументов ---
+
+template <typename T>
+vector<T> parseList(const string& text) {
+    vector<T> values;
+    stringstream stream(text);
+    string item;
+    while (getline(stream, item, ',')) {
+        if (item.empty()) continue;
+        values.push_back((T)atoll(item.c_str()));
+    }
+    return values;
+}
+
+vector<string> parseNames(const string& text) {
+    vector<string> names;
+    stringstream stream(text);
+    string item;
+    while (getline(stream, item, ',')) {
+        if (!item.empty()) names.push_back(item);
+    }
+    return names;
+}
+
+void printUsage(const char* program) {
+    cerr << "Usage: " << program << " [--threads 1,2,4] [--scales 1,2] [--reps 10] [--warmup 2]\n"
+         << "       [--kernels columns,diagonals,integrate,trapezoid,vowels] [--csv path] [--json path]" << endl;
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (i + 1 >= argc) {
+            printUsage(argv[0]);
+            return -1;
+        }
+        string value = argv[++i];
+        if (arg == "--threads") options.threads = parseList<int>(value);
+        else if (arg == "--scales") options.scales = parseList<long long>(value);
+        else if (arg == "--reps") options.repetitions = atoi(value.c_str());
+        else if (arg == "--warmup") options.warmup = atoi(value.c_str());
+        else if (arg == "--kernels") options.kernels = parseNames(value);
+        else if (arg == "--csv") options.csvPath = value;
+        else if (arg == "--json") options.jsonPath = value;
+        else {
+            printUsage(argv[0]);
+            return -1;
+        }
+    }
+
+    // По умолчанию — степени двойки до числа процессоров
+    if (options.threads.empty()) {
+        for (int p = 1; p < omp_get_num_procs(); p *= 2) options.threads.push_back(p);
+        options.threads.push_back(omp_get_num_procs());
+    }
+    sort(options.threads.begin(), options.threads.end());
+    options.threads.erase(unique(options.threads.begin(), options.threads.end()), options.threads.end());
+    if (options.threads.front() <= 0 || options.repetitions <= 0 || options.warmup < 0 || options.scales.empty() ||
+        *min_element(options.scales.begin(), options.scales.end()) <= 0) {
+        cerr << "Threads, scales and repetitions must be positive." << endl;
+        return -1;
+    }
+
+    vector<Kernel> kernels;
+    for (auto& kernel : makeKernels()) {
+        if (options.kernels.empty() ||
+            find(options.kernels.begin(), options.kernels.end(), kernel.name) != options.kernels.end()) {
+            kernels.push_back(kernel);
+        }
+    }
+    if (kernels.empty()) {
+        cerr << "No known kernels selected." << endl;
+        return -1;
+    }
+
+    // Динамическая подстройка числа нитей исказила бы замеры
+    omp_set_dynamic(0);
+
+    vector<Record> records;
+    printf("%-10s %-6s %7s %12s %12s %12s %10s\n", "kernel", "mode", "threads", "size", "median ms", "p95 ms",
+           "efficiency");
+    for (const auto& kernel : kernels) {
+        for (long long scale : options.scales) {
+            long long size = kernel.baseSize * scale;
+            const int p0 = options.threads.front();
+            double strongBase = 0, weakBase = 0;
+            for (const char* mode : {"strong", "weak"}) {
+                bool weak = strcmp(mode, "weak") == 0;
+                for (int p : options.threads) {
+                    // При слабой масштабируемости на каждую нить приходится одинаковый объём
+                    long long runSize = weak ? size * p / p0 : size;
+                    Record record = measure(kernel, mode, p, runSize, options);
+                    if (p == p0) (weak ? weakBase : strongBase) = record.medianMs;
+                    record.efficiency = weak ? weakBase / record.medianMs
+                                             : strongBase * p0 / (p * record.medianMs);
+                    printf("%-10s %-6s %7d %12lld %12.3f %12.3f %10.3f\n", record.kernel.c_str(), mode, p,
+                           runSize, record.medianMs, record.p95Ms, record.efficiency);
+                    records.push_back(record);
+                }
+            }
+        }
+    }
+
+    try {
+        if (!options.csvPath.empty()) writeCsv(options.csvPath, records);
+        if (!options.jsonPath.empty()) writeJson(options.jsonPath, records, options);
+    }
+    catch (const exception& e) {
+        cerr << e.what() << endl;
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <omp.h>
+
+#include "DeterministicSum.h"
+#include "Trace.h"
+
+// Сумма term(i) по [first, last) с распределением работы по оценке стоимости слагаемых.
+//
+// Когда стоимость term(i) сильно зависит от i, равные по числу слагаемых доли нитей
+// (schedule(static)) дают разную работу, и нити с дешёвыми слагаемыми простаивают
+// на барьере. Здесь единица работы — лист deterministicSum (kLeafSize слагаемых):
+//   Static    — равные непрерывные доли листьев (как у deterministicSum);
+//   Dynamic   — листья раздаются по одному по мере освобождения нитей;
+//   CostModel — leafCost(begin, end) оценивает стоимость каждого листа, и нити получают
+//               непрерывные диапазоны листьев с равной суммарной стоимостью.
+// Суммы листьев складываются в блоки и между блоками тем же попарным деревом,
+// что в deterministicSum, поэтому результат побитово совпадает с ним при любом
+// расписании и числе нитей. По желанию для каждой нити записываются время работы
+// и время ожидания остальных.
+
+enum class SumSchedule { Static, Dynamic, CostModel };
+
+// Нагрузка нити: время вычисления своих листьев, ожидание на барьере, оценка стоимости
+struct ThreadLoad {
+    double busy = 0.0;
+    double idle = 0.0;
+    double cost = 0.0;
+    int64_t leaves = 0;
+};
+
+namespace balanced_sum {
+
+// Границы непрерывных диапазонов листьев для numThreads нитей с равной суммой cost:
+// нить t получает листья [bounds[t], bounds[t + 1])
+inline std::vector<int64_t> partitionByCost(const std::vector<double>& cost, int numThreads) {
+    std::vector<double> prefix(cost.size() + 1, 0.0);
+    for (size_t l = 0; l < cost.size(); ++l) prefix[l + 1] = prefix[l] + cost[l];
+    std::vector<int64_t> bounds(numThreads + 1, 0);
+    bounds[numThreads] = cost.size();
+    for (int t = 1; t < numThreads; ++t) {
+        double target = prefix.back() * t / numThreads;
+        // Граница листа, ближайшая к доле target
+        int64_t k = std::lower_bound(prefix.begin(), prefix.end(), target) - prefix.begin();
+        if (k > 0 && target - prefix[k - 1] < prefix[std::min<int64_t>(k, cost.size())] - target) --k;
+        bounds[t] = std::max(bounds[t - 1], std::min<int64_t>(k, cost.size()));
+    }
+    return bounds;
+}
+
+// Отношение наибольшей доли стоимости к средней при разбиении cost на numThreads частей
+// (1 — идеальный баланс; на сколько дольше самой загруженной нити по модели)
+inline double predictedImbalance(const std::vector<double>& cost, int numThreads, SumSchedule schedule) {
+    std::vector<int64_t> bounds(numThreads + 1);
+    if (schedule == SumSchedule::CostModel) {
+        bounds = partitionByCost(cost, numThreads);
+    }
+    else {
+        for (int t = 0; t <= numThreads; ++t) bounds[t] = (int64_t)cost.size() * t / numThreads;
+    }
+    double total = 0.0, worst = 0.0;
+    for (int t = 0; t < numThreads; ++t) {
+        double share = 0.0;
+        for (int64_t l = bounds[t]; l < bounds[t + 1]; ++l) share += cost[l];
+        total += share;
+        worst = std::max(worst, share);
+    }
+    return total > 0.0 ? worst * numThreads / total : 1.0;
+}
+
+// Стоимость всех листьев [first, last)
+template <typename Cost>
+std::vector<double> leafCosts(int64_t first, int64_t last, const Cost& leafCost) {
+    using deterministic_sum::kLeafSize;
+    const int64_t leaves = last > first ? (last - first + kLeafSize - 1) / kLeafSize : 0;
+    std::vector<double> cost(leaves);
+#pragma omp parallel for schedule(static)
+    for (int64_t l = 0; l < leaves; ++l) {
+        int64_t begin = first + l * kLeafSize;
+        cost[l] = leafCost(begin, std::min(begin + kLeafSize, last));
+    }
+    return cost;
+}
+
+} // namespace balanced_sum
+
+template <typename Term, typename Cost>
+double balancedSum(int64_t first, int64_t last, const Term& term, const Cost& leafCost,
+                   SumSchedule schedule = SumSchedule::CostModel, std::vector<ThreadLoad>* loads = nullptr) {
+    using namespace deterministic_sum;
+    if (last <= first) return 0.0;
+    const int64_t leaves = (last - first + kLeafSize - 1) / kLeafSize;
+    const int64_t blocks = blockCount(first, last);
+    std::vector<double> leafSums(leaves);
+    std::vector<double> blockSums(blocks);
+
+    // Стоимость нужна для разбиения CostModel и для отчёта о нагрузке
+    std::vector<double> cost;
+    if (schedule == SumSchedule::CostModel || loads) cost = balanced_sum::leafCosts(first, last, leafCost);
+    if (loads) loads->assign(omp_get_max_threads(), ThreadLoad());
+
+    auto computeLeaf = [&](int64_t l, ThreadLoad& load) {
+        int64_t begin = first + l * kLeafSize;
+        leafSums[l] = leafSum(begin, std::min(begin + kLeafSize, last), term);
+        ++load.leaves;
+        if (!cost.empty()) load.cost += cost[l];
+    };
+
+    double sum = 0.0;
+    int usedThreads = 1;
+    std::vector<int64_t> bounds;
+#pragma omp parallel
+    {
+        const int numThreads = omp_get_num_threads();
+        const int threadId = omp_get_thread_num();
+        ThreadLoad load;
+#pragma omp single
+        {
+            usedThreads = numThreads;
+            if (schedule == SumSchedule::CostModel) bounds = balanced_sum::partitionByCost(cost, numThreads);
+        }
+        const double start = omp_get_wtime();
+
+        trace::begin("leaves");
+        if (schedule == SumSchedule::Dynamic) {
+#pragma omp for schedule(dynamic, 1) nowait
+            for (int64_t l = 0; l < leaves; ++l) computeLeaf(l, load);
+        }
+        else {
+            const int64_t begin = schedule == SumSchedule::CostModel ? bounds[threadId] : leaves * threadId / numThreads;
+            const int64_t end = schedule == SumSchedule::CostModel ? bounds[threadId + 1]
+                                                                    : leaves * (threadId + 1) / numThreads;
+            for (int64_t l = begin; l < end; ++l) computeLeaf(l, load);
+        }
+        load.busy = omp_get_wtime() - start;
+        trace::end("leaves");
+
+        trace::barrier();
+        load.idle = omp_get_wtime() - start - load.busy;
+        if (loads && threadId < (int)loads->size()) (*loads)[threadId] = load;
+
+        // Суммы блоков из листьев и попарная сумма блоков — то же дерево, что в deterministicSum
+#pragma omp for schedule(static)
+        for (int64_t k = 0; k < blocks; ++k) {
+            int64_t leafBegin = k * kLeavesPerBlock;
+            int64_t leafEnd = std::min(leafBegin + kLeavesPerBlock, leaves);
+            blockSums[k] = pairwise(leafSums.data() + leafBegin, leafEnd - leafBegin);
+        }
+#pragma omp master
+        sum = pairwise(blockSums.data(), blocks);
+    }
+    if (loads) loads->resize(usedThreads);
+    return sum;
+}
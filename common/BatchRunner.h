@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <exception>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <omp.h>
+
+#include "Trace.h"
+
+// Пакетный режим: задания читаются построчно из потока и выполняются одной
+// долгоживущей командой нитей OpenMP.
+//
+// Вся обработка идёт внутри одной parallel-области, поэтому команда нитей
+// создаётся один раз, а не на каждое задание. Одна нить (single) печатает результат
+// предыдущего задания, читает и разбирает следующую строку; затем все нити вместе
+// выполняют задание (execute вызывается каждой нитью и должен распределять работу
+// через orphaned `#pragma omp for` или номера нитей). Накладные расходы на задание —
+// два барьера вместо создания команды и выделения памяти.
+//
+// Строки пустые и начинающиеся с '#' пропускаются. parse(line, job) вызывается одной
+// нитью и может перевыделять общие буферы; при ошибке он бросает исключение, и вместо
+// результата в out пишется строка "error: ...". report(index, job, seconds, out)
+// пишет результат задания, после каждого результата поток сбрасывается.
+// Возвращает число выполненных заданий.
+template <typename Job, typename Parse, typename Execute, typename Report>
+size_t runBatch(std::istream& in, std::ostream& out, Job& job, Parse parse, Execute execute, Report report) {
+    std::string line;
+    size_t lineNumber = 0;
+    size_t executed = 0;
+    bool ready = false;
+    bool done = false;
+    double startTime = 0.0;
+
+#pragma omp parallel
+    {
+        while (true) {
+#pragma omp single
+            {
+                TraceScope reading("read job", "batch");
+                if (ready) {
+                    report(executed, job, omp_get_wtime() - startTime, out);
+                    out.flush();
+                    ++executed;
+                    ready = false;
+                }
+                while (!ready && std::getline(in, line)) {
+                    ++lineNumber;
+                    size_t first = line.find_first_not_of(" \t\r");
+                    if (first == std::string::npos || line[first] == '#') continue;
+                    try {
+                        startTime = omp_get_wtime();
+                        parse(line, job);
+                        ready = true;
+                    }
+                    catch (const std::exception& e) {
+                        out << "error: line " << lineNumber << ": " << e.what() << std::endl;
+                    }
+                }
+                done = !ready;
+            }
+            if (done) break;
+
+            {
+                TraceScope running("job", "batch");
+                execute(job);
+            }
+            // Результат готов только когда все нити закончили
+            trace::barrier();
+        }
+    }
+    return executed;
+}
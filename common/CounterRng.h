@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+
+// Генератор случайных чисел на счётчике (SplitMix64).
+//
+// Значение зависит только от ключа и номера элемента, а не от предыдущих вызовов,
+// поэтому любой элемент можно получить независимо: порядок обхода, разбиение
+// между нитями и процессами на результат не влияют. Состояния нет, так что
+// генератор потокобезопасен, а цикл по номерам элементов векторизуется.
+
+namespace counter_rng {
+
+constexpr uint64_t kGamma = 0x9E3779B97F4A7C15ULL;
+
+// Финализатор SplitMix64: биективное перемешивание 64-битного слова
+inline uint64_t mix(uint64_t x) {
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+// Ключ потока, например строки матрицы: разные (seed, stream) дают независимые потоки
+inline uint64_t streamKey(uint64_t seed, uint64_t stream) {
+    return mix(seed * kGamma + mix(stream + kGamma));
+}
+
+// Элемент counter потока key
+inline uint64_t at(uint64_t key, uint64_t counter) {
+    return mix(key + (counter + 1) * kGamma);
+}
+
+// Равномерное число из [0, bound) без деления: старшие 32 бита, умноженные на bound
+inline uint32_t bounded(uint64_t x, uint32_t bound) {
+    return static_cast<uint32_t>(((x >> 32) * bound) >> 32);
+}
+
+} // namespace counter_rng
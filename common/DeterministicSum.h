@@ -0,0 +1,121 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <omp.h>
+
+// Параллельная сумма term(i) по i из [first, last) с фиксированным деревом сложения.
+//
+// Диапазон режется на блоки по kBlockSize слагаемых, блок — на листья по kLeafSize.
+// Лист суммируется SIMD-циклом, листья блока и суммы блоков складываются попарно.
+// Границы блоков и листьев зависят только от first и last, а не от числа нитей
+// и расписания, поэтому результат побитово одинаков при любом OMP_NUM_THREADS.
+// Попарное сложение даёт рост погрешности O(log n) вместо O(n) у простого цикла.
+
+namespace deterministic_sum {
+
+constexpr int64_t kLeafSize = 1024;
+constexpr int64_t kLeavesPerBlock = 64;
+constexpr int64_t kBlockSize = kLeafSize * kLeavesPerBlock;
+
+// Попарная сумма массива: дерево задаётся только длиной массива
+inline double pairwise(const double* values, size_t count) {
+    if (count <= 8) {
+        double sum = 0.0;
+        for (size_t k = 0; k < count; ++k) sum += values[k];
+        return sum;
+    }
+    size_t half = count / 2;
+    return pairwise(values, half) + pairwise(values + half, count - half);
+}
+
+template <typename Term>
+double leafSum(int64_t first, int64_t last, const Term& term) {
+    double sum = 0.0;
+#pragma omp simd reduction(+:sum)
+    for (int64_t i = first; i < last; ++i) sum += term(i);
+    return sum;
+}
+
+// Сумма блока, листья которого считает leaf(begin, end) — сумма term(i) по [begin, end)
+template <typename Leaf>
+double blockSumOfLeaves(int64_t first, int64_t last, const Leaf& leaf) {
+    double leaves[kLeavesPerBlock];
+    size_t count = 0;
+    for (int64_t i = first; i < last; i += kLeafSize) {
+        leaves[count++] = leaf(i, std::min(i + kLeafSize, last));
+    }
+    return pairwise(leaves, count);
+}
+
+template <typename Term>
+double blockSum(int64_t first, int64_t last, const Term& term) {
+    return blockSumOfLeaves(first, last, [&](int64_t begin, int64_t end) { return leafSum(begin, end, term); });
+}
+
+inline int64_t blockCount(int64_t first, int64_t last) {
+    return last > first ? (last - first + kBlockSize - 1) / kBlockSize : 0;
+}
+
+// Сумма, считаемая всей командой нитей внутри parallel-области (вызывается каждой нитью).
+// partial — общий буфер не короче blockCount(first, last); все нити возвращают одно значение.
+// То же для листьев, вычисляемых целиком функцией leaf(begin, end)
+template <typename Leaf>
+double teamSumOfLeaves(int64_t first, int64_t last, const Leaf& leaf, double* partial) {
+    const int64_t blocks = blockCount(first, last);
+
+#pragma omp for schedule(static)
+    for (int64_t k = 0; k < blocks; ++k) {
+        int64_t begin = first + k * kBlockSize;
+        partial[k] = blockSumOfLeaves(begin, std::min(begin + kBlockSize, last), leaf);
+    }
+
+    return pairwise(partial, blocks);
+}
+
+template <typename Term>
+double teamSum(int64_t first, int64_t last, const Term& term, double* partial) {
+    return teamSumOfLeaves(first, last, [&](int64_t begin, int64_t end) { return leafSum(begin, end, term); },
+                           partial);
+}
+
+// Суммы блоков с номерами [blockBegin, blockEnd) в out — для распределения блоков
+// между процессами: сложив все суммы через pairwise, получим ровно deterministicSum
+template <typename Term>
+void blockSums(int64_t first, int64_t last, int64_t blockBegin, int64_t blockEnd, const Term& term, double* out) {
+#pragma omp parallel for schedule(static)
+    for (int64_t k = blockBegin; k < blockEnd; ++k) {
+        int64_t begin = first + k * kBlockSize;
+        out[k - blockBegin] = blockSum(begin, std::min(begin + kBlockSize, last), term);
+    }
+}
+
+} // namespace deterministic_sum
+
+// Вариант deterministicSum, в котором слагаемые считаются сразу целым листом:
+// leaf(begin, end) возвращает сумму term(i) по [begin, end), длина листа не больше kLeafSize
+template <typename Leaf>
+double deterministicSumOfLeaves(int64_t first, int64_t last, const Leaf& leaf) {
+    using namespace deterministic_sum;
+    if (last <= first) return 0.0;
+    std::vector<double> partial(blockCount(first, last));
+    double sum = 0.0;
+
+#pragma omp parallel
+    {
+        double teamResult = teamSumOfLeaves(first, last, leaf, partial.data());
+#pragma omp master
+        sum = teamResult;
+    }
+
+    return sum;
+}
+
+template <typename Term>
+double deterministicSum(int64_t first, int64_t last, const Term& term) {
+    return deterministicSumOfLeaves(first, last, [&](int64_t begin, int64_t end) {
+        return deterministic_sum::leafSum(begin, end, term);
+    });
+}
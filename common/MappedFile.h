@@ -0,0 +1,63 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Файл, отображённый в память только для чтения. Данные не копируются:
+// страницы подгружаются ядром по мере обращения и могут быть вытеснены обратно.
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path) {
+        fd_ = ::open(path.c_str(), O_RDONLY);
+        if (fd_ < 0) throw std::runtime_error("Cannot open file: " + path);
+
+        struct stat st {};
+        if (fstat(fd_, &st) != 0) {
+            ::close(fd_);
+            throw std::runtime_error("Cannot stat file: " + path);
+        }
+        size_ = st.st_size;
+
+        if (size_ > 0) {
+            void* p = mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd_, 0);
+            if (p == MAP_FAILED) {
+                ::close(fd_);
+                throw std::runtime_error("Cannot mmap file: " + path);
+            }
+            data_ = static_cast<const char*>(p);
+        }
+    }
+
+    ~MappedFile() {
+        if (data_) munmap(const_cast<char*>(data_), size_);
+        if (fd_ >= 0) ::close(fd_);
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* data() const { return data_; }
+    size_t size() const { return size_; }
+
+    // Подсказка ядру о байтах [begin, end) (MADV_SEQUENTIAL, MADV_WILLNEED, MADV_DONTNEED).
+    // Для MADV_DONTNEED затрагиваются только страницы, целиком лежащие внутри диапазона.
+    void advise(size_t begin, size_t end, int advice) const {
+        end = std::min(end, size_);
+        if (!data_ || begin >= end) return;
+        size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        size_t alignedBegin = advice == MADV_DONTNEED ? (begin + page - 1) / page * page : begin / page * page;
+        if (advice == MADV_DONTNEED) end = end / page * page;
+        if (alignedBegin < end) madvise(const_cast<char*>(data_) + alignedBegin, end - alignedBegin, advice);
+    }
+
+private:
+    int fd_ = -1;
+    size_t size_ = 0;
+    const char* data_ = nullptr;
+};
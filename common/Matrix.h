@@ -0,0 +1,117 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+template <typename T>
+class Matrix;
+
+// Невладеющее представление построчной матрицы: указатель на первую строку,
+// размеры и расстояние между строками в элементах. Данные могут лежать где угодно,
+// в том числе в отображённом в память файле.
+template <typename T>
+struct MatrixView {
+    const T* data = nullptr;
+    size_t rowsCount = 0;
+    size_t colsCount = 0;
+    size_t rowStride = 0;
+
+    MatrixView() = default;
+    MatrixView(const T* data, size_t rows, size_t cols, size_t stride)
+        : data(data), rowsCount(rows), colsCount(cols), rowStride(stride) {}
+    MatrixView(const Matrix<T>& matrix)
+        : MatrixView(matrix.data(), matrix.rows(), matrix.cols(), matrix.stride()) {}
+
+    size_t rows() const { return rowsCount; }
+    size_t cols() const { return colsCount; }
+    size_t stride() const { return rowStride; }
+    const T* row(size_t i) const { return data + i * rowStride; }
+    const T& operator()(size_t i, size_t j) const { return row(i)[j]; }
+
+    // Подматрица из строк [rowBegin, rowEnd)
+    MatrixView rowRange(size_t rowBegin, size_t rowEnd) const {
+        return MatrixView(row(rowBegin), rowEnd - rowBegin, colsCount, rowStride);
+    }
+};
+
+// Плотная матрица, хранящаяся построчно в одном непрерывном блоке памяти.
+// Длина строки в памяти (stride) дополняется до кратного 64 байтам, поэтому
+// каждая строка начинается с границы кэш-линии и SIMD-загрузки по строке выровнены.
+// Память не инициализируется при создании: первое касание страниц делает тот,
+// кто заполняет матрицу.
+template <typename T>
+class Matrix {
+    static_assert(std::is_trivially_copyable<T>::value, "Matrix хранит только тривиальные типы");
+
+public:
+    static constexpr size_t kAlignment = 64;
+
+    Matrix() = default;
+
+    Matrix(size_t rows, size_t cols)
+        : rows_(rows), cols_(cols), stride_(paddedStride(cols)), capacity_(rows * stride_) {
+        size_t bytes = capacity_ * sizeof(T);
+        if (bytes > 0) {
+            void* p = std::aligned_alloc(kAlignment, bytes);
+            if (!p) throw std::bad_alloc();
+            data_.reset(static_cast<T*>(p));
+        }
+    }
+
+    // Смена размеров с повторным использованием памяти: новый блок выделяется,
+    // только если текущего не хватает. Содержимое после вызова не определено.
+    void reshape(size_t rows, size_t cols) {
+        size_t stride = paddedStride(cols);
+        if (rows * stride > capacity_) *this = Matrix(rows, cols);
+        rows_ = rows;
+        cols_ = cols;
+        stride_ = stride;
+    }
+
+    // Копия матрицы из представления vector<vector<T>>
+    static Matrix fromNested(const std::vector<std::vector<T>>& nested) {
+        size_t rows = nested.size();
+        size_t cols = rows ? nested[0].size() : 0;
+        Matrix result(rows, cols);
+        for (size_t i = 0; i < rows; ++i) {
+            std::copy(nested[i].begin(), nested[i].end(), result.row(i));
+        }
+        return result;
+    }
+
+    size_t rows() const { return rows_; }
+    size_t cols() const { return cols_; }
+    // Расстояние между началами соседних строк в элементах
+    size_t stride() const { return stride_; }
+
+    T* data() { return data_.get(); }
+    const T* data() const { return data_.get(); }
+
+    T* row(size_t i) { return data_.get() + i * stride_; }
+    const T* row(size_t i) const { return data_.get() + i * stride_; }
+
+    T& operator()(size_t i, size_t j) { return row(i)[j]; }
+    const T& operator()(size_t i, size_t j) const { return row(i)[j]; }
+
+    // Длина строки, дополненная до кратного kAlignment байтам
+    static size_t paddedStride(size_t cols) {
+        constexpr size_t perLine = kAlignment / sizeof(T) ? kAlignment / sizeof(T) : 1;
+        return (cols + perLine - 1) / perLine * perLine;
+    }
+
+private:
+    struct FreeDeleter {
+        void operator()(T* p) const { std::free(p); }
+    };
+
+    size_t rows_ = 0;
+    size_t cols_ = 0;
+    size_t stride_ = 0;
+    size_t capacity_ = 0; // выделено элементов
+    std::unique_ptr<T[], FreeDeleter> data_;
+};
@@ -0,0 +1,199 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <sys/mman.h>
+
+#include "MappedFile.h"
+#include "Matrix.h"
+
+// Двоичный формат матрицы:
+//   заголовок MatrixFileHeader (64 байта), затем rows строк по stride элементов,
+//   строки начинаются со смещения dataOffset. Порядок байт — родной для машины.
+// Файл не читается, а отображается в память (mmap), поэтому данные не копируются,
+// а матрица может быть больше оперативной памяти: ядра проходят её порциями строк,
+// ядро подкачивает следующую порцию заранее и выбрасывает уже обработанные страницы.
+
+enum class MatrixElementType : uint32_t {
+    Int8 = 1,
+    Int16 = 2,
+    Int32 = 3,
+    Float32 = 4,
+    Float64 = 5,
+};
+
+inline size_t elementSize(MatrixElementType type) {
+    switch (type) {
+    case MatrixElementType::Int8: return 1;
+    case MatrixElementType::Int16: return 2;
+    case MatrixElementType::Int32: return 4;
+    case MatrixElementType::Float32: return 4;
+    case MatrixElementType::Float64: return 8;
+    }
+    return 0;
+}
+
+template <typename T> struct MatrixElementTypeOf;
+template <> struct MatrixElementTypeOf<int8_t> { static constexpr MatrixElementType value = MatrixElementType::Int8; };
+template <> struct MatrixElementTypeOf<int16_t> { static constexpr MatrixElementType value = MatrixElementType::Int16; };
+template <> struct MatrixElementTypeOf<int32_t> { static constexpr MatrixElementType value = MatrixElementType::Int32; };
+template <> struct MatrixElementTypeOf<float> { static constexpr MatrixElementType value = MatrixElementType::Float32; };
+template <> struct MatrixElementTypeOf<double> { static constexpr MatrixElementType value = MatrixElementType::Float64; };
+
+struct MatrixFileHeader {
+    char magic[8];        // "OMPMAT1\0"
+    uint32_t version;     // версия формата, сейчас 1
+    uint32_t elementType; // MatrixElementType
+    uint64_t rows;
+    uint64_t cols;
+    uint64_t stride;      // длина строки в файле в элементах (>= cols)
+    uint64_t dataOffset;  // смещение первой строки от начала файла
+    uint8_t reserved[16];
+};
+static_assert(sizeof(MatrixFileHeader) == 64, "Заголовок файла матрицы должен занимать 64 байта");
+
+constexpr char kMatrixFileMagic[8] = {'O', 'M', 'P', 'M', 'A', 'T', '1', '\0'};
+constexpr uint32_t kMatrixFileVersion = 1;
+
+inline MatrixFileHeader makeMatrixFileHeader(MatrixElementType type, uint64_t rows, uint64_t cols,
+                                             uint64_t stride) {
+    MatrixFileHeader header{};
+    std::memcpy(header.magic, kMatrixFileMagic, sizeof(header.magic));
+    header.version = kMatrixFileVersion;
+    header.elementType = static_cast<uint32_t>(type);
+    header.rows = rows;
+    header.cols = cols;
+    header.stride = stride;
+    header.dataOffset = sizeof(MatrixFileHeader);
+    return header;
+}
+
+// Файл матрицы, отображённый в память только для чтения
+class MappedMatrixFile {
+public:
+    explicit MappedMatrixFile(const std::string& path) : file_(path) {
+        if (file_.size() < sizeof(MatrixFileHeader)) throw std::runtime_error("Matrix file is too small: " + path);
+        std::memcpy(&header_, file_.data(), sizeof(header_));
+
+        const char* error = validate();
+        if (error) throw std::runtime_error(std::string(error) + ": " + path);
+        // Основной режим — последовательный проход, пусть ядро читает с упреждением
+        file_.advise(0, file_.size(), MADV_SEQUENTIAL);
+    }
+
+    const MatrixFileHeader& header() const { return header_; }
+    size_t rows() const { return header_.rows; }
+    size_t cols() const { return header_.cols; }
+    MatrixElementType elementType() const { return static_cast<MatrixElementType>(header_.elementType); }
+
+    // Представление всей матрицы; тип элемента должен совпадать с записанным в файле
+    template <typename T>
+    MatrixView<T> view() const {
+        if (elementType() != MatrixElementTypeOf<T>::value) {
+            throw std::runtime_error("Matrix file element type mismatch");
+        }
+        return MatrixView<T>(reinterpret_cast<const T*>(file_.data() + header_.dataOffset),
+                             header_.rows, header_.cols, header_.stride);
+    }
+
+    // Подсказка ядру: строки [rowBegin, rowEnd) скоро понадобятся
+    void prefetchRows(size_t rowBegin, size_t rowEnd) const {
+        file_.advise(rowOffset(rowBegin), rowOffset(rowEnd), MADV_WILLNEED);
+    }
+    // Строки [rowBegin, rowEnd) больше не нужны, страницы можно вытеснить
+    void releaseRows(size_t rowBegin, size_t rowEnd) const {
+        file_.advise(rowOffset(rowBegin), rowOffset(rowEnd), MADV_DONTNEED);
+    }
+
+    // Число строк в порции примерно chunkBytes байт
+    size_t rowsPerChunk(size_t chunkBytes) const {
+        size_t rowBytes = header_.stride * elementSize(elementType());
+        return rowBytes ? std::max<size_t>(1, chunkBytes / rowBytes) : 1;
+    }
+
+private:
+    const char* validate() const {
+        if (std::memcmp(header_.magic, kMatrixFileMagic, sizeof(kMatrixFileMagic)) != 0) return "Bad matrix file magic";
+        if (header_.version != kMatrixFileVersion) return "Unsupported matrix file version";
+        size_t elem = elementSize(elementType());
+        if (elem == 0) return "Unknown matrix element type";
+        if (header_.stride < header_.cols) return "Matrix row stride is smaller than column count";
+        if (header_.dataOffset < sizeof(MatrixFileHeader) || header_.dataOffset % elem != 0) return "Bad matrix data offset";
+        if (header_.dataOffset > file_.size()) return "Bad matrix data offset";
+        if (header_.rows > 0 && header_.stride > 0 &&
+            (file_.size() - header_.dataOffset) / elem / header_.stride < header_.rows) return "Matrix file is truncated";
+        return nullptr;
+    }
+
+    size_t rowOffset(size_t row) const {
+        return header_.dataOffset + row * header_.stride * elementSize(elementType());
+    }
+
+    MappedFile file_;
+    MatrixFileHeader header_{};
+};
+
+// Последовательная обработка строк [rowBegin, rowEnd) файла порциями по ~chunkBytes байт.
+// process(view, chunkBegin) получает подматрицу порции и номер её первой строки в файле.
+// Пока обрабатывается порция, следующая подкачивается, обработанная отпускается.
+template <typename T, typename Process>
+void forEachRowChunk(const MappedMatrixFile& file, size_t chunkBytes, Process process,
+                     size_t rowBegin = 0, size_t rowEnd = SIZE_MAX) {
+    MatrixView<T> all = file.view<T>();
+    rowEnd = std::min(rowEnd, all.rows());
+    const size_t chunkRows = file.rowsPerChunk(chunkBytes);
+    for (size_t begin = rowBegin; begin < rowEnd; begin += chunkRows) {
+        size_t end = std::min(begin + chunkRows, rowEnd);
+        file.prefetchRows(end, std::min(end + chunkRows, rowEnd));
+        process(all.rowRange(begin, end), begin);
+        file.releaseRows(begin, end);
+    }
+}
+
+// Запись матрицы в файл: заголовок, затем строки по одной.
+// Строки дополняются нулями до stride элементов.
+class MatrixFileWriter {
+public:
+    MatrixFileWriter(const std::string& path, MatrixElementType type, uint64_t rows, uint64_t cols,
+                     uint64_t stride)
+        : header_(makeMatrixFileHeader(type, rows, cols, std::max(stride, cols))),
+          padding_((header_.stride - cols) * elementSize(type), 0) {
+        file_ = std::fopen(path.c_str(), "wb");
+        if (!file_) throw std::runtime_error("Cannot create matrix file: " + path);
+        write(&header_, sizeof(header_));
+    }
+
+    ~MatrixFileWriter() {
+        if (file_) std::fclose(file_);
+    }
+
+    MatrixFileWriter(const MatrixFileWriter&) = delete;
+    MatrixFileWriter& operator=(const MatrixFileWriter&) = delete;
+
+    // Дописать очередную строку из cols элементов
+    void writeRow(const void* row) {
+        write(row, header_.cols * elementSize(static_cast<MatrixElementType>(header_.elementType)));
+        write(padding_.data(), padding_.size());
+    }
+
+    void close() {
+        std::FILE* file = file_;
+        file_ = nullptr;
+        if (file && std::fclose(file) != 0) throw std::runtime_error("Cannot finish matrix file");
+    }
+
+private:
+    void write(const void* data, size_t bytes) {
+        if (bytes && std::fwrite(data, 1, bytes, file_) != bytes) throw std::runtime_error("Matrix file write failed");
+    }
+
+    MatrixFileHeader header_;
+    std::vector<char> padding_;
+    std::FILE* file_ = nullptr;
+};
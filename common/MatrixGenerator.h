@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include <omp.h>
+
+#include "CounterRng.h"
+#include "Matrix.h"
+
+// Генерация матриц случайными числами от 0 до modulus - 1.
+//
+// Элемент (i, j) глобальной матрицы — это counter_rng::at(streamKey(seed, i), j),
+// т. е. зависит только от seed и своих координат. Результат не зависит от разбиения
+// на блоки, числа нитей и процессов.
+//
+// Строки делятся между нитями статическим разбиением: нить t из p получает строки
+// [m * t / p, m * (t + 1) / p). В ядрах с тем же разбиением строк (findMaxInColumnsSimd,
+// computeColumnStatistics, findMaxOnDiagonalsBlocked) страницы строки впервые касается та нить,
+// которая потом её читает, и при first-touch политике они оказываются на её узле NUMA.
+
+// Заполнение строки globalRow глобальной матрицы (cols элементов)
+inline void generateRow(int* row, size_t cols, long long globalRow, int modulus = 1000, uint64_t seed = 0) {
+    const uint64_t key = counter_rng::streamKey(seed, static_cast<uint64_t>(globalRow));
+#pragma omp simd
+    for (size_t j = 0; j < cols; ++j) {
+        row[j] = static_cast<int>(counter_rng::bounded(counter_rng::at(key, j), modulus));
+    }
+}
+
+// Заполнение строки i блока, первая строка которого — глобальная строка rowBegin
+inline void generateRow(Matrix<int>& block, long long rowBegin, long long i, int modulus = 1000, uint64_t seed = 0) {
+    generateRow(block.row(i), block.cols(), rowBegin + i, modulus, seed);
+}
+
+// Заполнение блока строк [rowBegin, rowBegin + block.rows()) глобальной матрицы
+inline void generateRowBlock(Matrix<int>& block, long long rowBegin, int modulus = 1000, uint64_t seed = 0) {
+    const long long m = block.rows();
+#pragma omp parallel
+    {
+        const int numThreads = omp_get_num_threads();
+        const int threadId = omp_get_thread_num();
+        const long long begin = m * threadId / numThreads;
+        const long long end = m * (threadId + 1) / numThreads;
+        for (long long i = begin; i < end; ++i) generateRow(block, rowBegin, i, modulus, seed);
+    }
+}
+
+// Та же матрица m×n в представлении vector<vector<int>>; каждая строка выделяется
+// и заполняется нитью, которой она достаётся при статическом разбиении.
+// Исходные ядра над этим представлением (findMaxInColumnsParallel делит столбцы,
+// findMaxOnDiagonalsParallel — диагонали) читают каждой нитью все строки, так что
+// локальности чтения это не даёт; выигрыш в другом — страницы распределяются по узлам
+// NUMA поровну, а не все на узле главной нити, и чтение идёт из памяти всех узлов сразу.
+// Заполнение к тому же просто параллельное.
+inline std::vector<std::vector<int>> generateNestedMatrix(long long m, long long n, int modulus = 1000,
+                                                          uint64_t seed = 0) {
+    std::vector<std::vector<int>> matrix(m);
+#pragma omp parallel
+    {
+        const int numThreads = omp_get_num_threads();
+        const int threadId = omp_get_thread_num();
+        const long long begin = m * threadId / numThreads;
+        const long long end = m * (threadId + 1) / numThreads;
+        for (long long i = begin; i < end; ++i) {
+            std::vector<int> row(n);
+            generateRow(row.data(), n, i, modulus, seed);
+            matrix[i] = std::move(row);
+        }
+    }
+    return matrix;
+}
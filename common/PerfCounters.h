@@ -0,0 +1,181 @@
+#pragma once
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+#include <omp.h>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Аппаратные счётчики производительности (perf_event_open) для именованных участков кода.
+//
+// PerfRegion при создании открывает на каждой нити команды OpenMP группу счётчиков
+// (такты, инструкции, промахи последнего уровня кэша, промахи предсказания переходов)
+// и запускает её; stop() останавливает и считывает группы. Ядро между ними выполняется
+// теми же нитями пула OpenMP, поэтому счётчики нити t относятся к её доле работы.
+// Считаются только события пользовательского режима (exclude_kernel), что разрешено
+// при perf_event_paranoid <= 2. Если ядро ОС не даёт открыть счётчики (контейнер,
+// виртуальная машина без PMU, paranoid = 3), участок просто не измеряется, а print()
+// один раз сообщает причину. Отключить счётчики можно переменной окружения PERF_COUNTERS=0.
+
+namespace perf_counters {
+
+enum Event { Cycles, Instructions, CacheMisses, BranchMisses, kEventCount };
+
+// Счётчики одной нити
+struct ThreadCounters {
+    int fds[kEventCount] = {-1, -1, -1, -1};
+    uint64_t values[kEventCount] = {};
+    int error = 0; // errno первой неудачной попытки, 0 — счётчики работали
+
+#if defined(__linux__)
+    static int openEvent(uint64_t config, int groupFd) {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = config;
+        attr.disabled = groupFd == -1 ? 1 : 0;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP;
+        return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, groupFd, 0));
+    }
+
+    void start() {
+        static const uint64_t configs[kEventCount] = {
+            PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+            PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+        error = 0;
+        for (int e = 0; e < kEventCount; ++e) {
+            fds[e] = openEvent(configs[e], e == 0 ? -1 : fds[0]);
+            if (fds[e] < 0) {
+                error = errno ? errno : EINVAL;
+                close();
+                return;
+            }
+        }
+        ioctl(fds[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+
+    void stop() {
+        if (fds[0] < 0) return;
+        ioctl(fds[0], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+        // Формат группы: число событий, затем значения в порядке открытия
+        uint64_t buffer[1 + kEventCount] = {};
+        if (::read(fds[0], buffer, sizeof(buffer)) == (ssize_t)sizeof(buffer) && buffer[0] == kEventCount) {
+            for (int e = 0; e < kEventCount; ++e) values[e] = buffer[1 + e];
+        }
+        else {
+            error = EIO;
+        }
+        close();
+    }
+
+    void close() {
+        for (int& fd : fds) {
+            if (fd >= 0) ::close(fd);
+            fd = -1;
+        }
+    }
+#else
+    void start() { error = ENOSYS; }
+    void stop() {}
+#endif
+};
+
+inline bool disabledByEnvironment() {
+    const char* value = std::getenv("PERF_COUNTERS");
+    return value && std::string(value) == "0";
+}
+
+} // namespace perf_counters
+
+class PerfRegion {
+public:
+    explicit PerfRegion(std::string name) : name_(std::move(name)) {
+        if (perf_counters::disabledByEnvironment()) return;
+        threads_.resize(omp_get_max_threads());
+#pragma omp parallel
+        {
+            int t = omp_get_thread_num();
+            if (t < (int)threads_.size()) threads_[t].start();
+        }
+    }
+
+    PerfRegion(const PerfRegion&) = delete;
+    PerfRegion& operator=(const PerfRegion&) = delete;
+
+    void stop() {
+        if (threads_.empty() || stopped_) return;
+        stopped_ = true;
+#pragma omp parallel
+        {
+            int t = omp_get_thread_num();
+            if (t < (int)threads_.size()) threads_[t].stop();
+        }
+    }
+
+    // Строка "perf: IPC ..., промахи на элемент" для участка, обработавшего elements элементов
+    void print(std::ostream& out, double elements) {
+        using namespace perf_counters;
+        stop();
+        if (threads_.empty()) return;
+
+        uint64_t total[kEventCount] = {};
+        int failed = 0;
+        for (const auto& thread : threads_) {
+            if (thread.error) {
+                failed = thread.error;
+                continue;
+            }
+            for (int e = 0; e < kEventCount; ++e) total[e] += thread.values[e];
+        }
+        if (failed && total[Cycles] == 0) {
+            // Причину сообщаем один раз за запуск
+            static bool reported = false;
+            if (!reported) {
+                reported = true;
+                out << "  perf: counters unavailable (" << std::strerror(failed)
+                    << "), check /proc/sys/kernel/perf_event_paranoid" << std::endl;
+            }
+            return;
+        }
+
+        char line[256];
+        std::snprintf(line, sizeof(line),
+                      "  perf [%s]: IPC %.2f, cycles/elem %.3f, LLC misses/elem %.4f, branch misses/elem %.4f",
+                      name_.c_str(), ratio(total[Instructions], total[Cycles]), total[Cycles] / elements,
+                      total[CacheMisses] / elements, total[BranchMisses] / elements);
+        out << line;
+        // IPC по нитям показывает, какие нити простаивают или упираются в память
+        if (threads_.size() > 1) {
+            out << ", IPC per thread:";
+            for (const auto& thread : threads_) {
+                std::snprintf(line, sizeof(line), " %.2f",
+                              ratio(thread.values[Instructions], thread.values[Cycles]));
+                out << line;
+            }
+        }
+        out << std::endl;
+    }
+
+private:
+    static double ratio(uint64_t a, uint64_t b) { return b ? (double)a / b : 0.0; }
+
+    std::string name_;
+    std::vector<perf_counters::ThreadCounters> threads_;
+    bool stopped_ = false;
+};
@@ -0,0 +1,369 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <omp.h>
+#include <unistd.h>
+
+#ifdef TRACE_OMPT
+#include <omp-tools.h>
+#endif
+
+// Трассировка нитей OpenMP во времени в формате Chrome trace JSON (chrome://tracing, ui.perfetto.dev).
+//
+// Включается переменной окружения TRACE_FILE=<путь>; без неё любой маркер — одна проверка флага.
+// Каждая нить пишет интервалы (имя, категория, начало, длительность) в свой буфер из кусков
+// по kChunkEvents событий: запись идёт без блокировок и без копирования при росте, мьютекс
+// берётся только при первом событии нити, чтобы внести её буфер в общий список.
+// Файл записывается при завершении программы (std::atexit).
+//
+// Источники событий:
+//   - инструмент OMPT (сборка с -DTRACE_OMPT=ON и libomp из LLVM, libgomp OMPT не поддерживает):
+//     неявные задачи параллельных областей, ожидание на барьерах, taskwait и taskgroup,
+//     ожидание и удержание critical/omp_lock_t, явные задачи. Из worksharing-конструкций видны
+//     только те, что g++ реализует вызовами среды: циклы schedule(dynamic/guided/runtime), sections.
+//     Цикл schedule(static) g++ разворачивает в арифметику по номеру нити без обращения к среде,
+//     и OMPT о нём не узнаёт — такую работу отмечают ручные маркеры (Marker::Work пишется всегда);
+//   - ручные маркеры TraceScope и trace::begin/end — участки работы в самих программах;
+//     маркеры конструкций (Marker::Construct, trace::barrier) пишутся, только если OMPT
+//     недоступен, чтобы те же ожидания не попадали в трассу дважды.
+//
+// Определение ompt_start_tool в этом заголовке: он подключается в одну единицу трансляции программы.
+
+namespace trace {
+
+constexpr size_t kChunkEvents = 4096;
+constexpr size_t kMaxOpen = 256; // глубже интервалы не открываются (защита от незакрытых)
+
+enum class Marker {
+    Work,      // участок работы, пишется всегда
+    Construct  // конструкция OpenMP (барьер, critical), пишется без OMPT
+};
+
+struct Event {
+    const char* name;
+    const char* category;
+    uint64_t start; // нс от начала трассы
+    uint64_t duration;
+};
+
+// Буфер одной нити: закрытые интервалы по кускам и стек открытых
+struct ThreadTrace {
+    int tid = 0;
+    std::string name;
+    std::vector<std::unique_ptr<Event[]>> chunks;
+    size_t used = kChunkEvents; // занято в последнем куске
+    std::vector<Event> open;
+
+    void push(const Event& event) {
+        if (used == kChunkEvents) {
+            chunks.emplace_back(new Event[kChunkEvents]);
+            used = 0;
+        }
+        chunks.back()[used++] = event;
+    }
+
+    size_t size() const { return chunks.empty() ? 0 : (chunks.size() - 1) * kChunkEvents + used; }
+};
+
+class Recorder {
+public:
+    Recorder() : origin_(std::chrono::steady_clock::now()) {
+        const char* path = std::getenv("TRACE_FILE");
+        if (!path || !*path) return;
+        path_ = path;
+        pid_ = getpid();
+        // Под mpirun у каждого процесса свой файл: trace.json -> trace.<rank>.json
+        const char* rank = std::getenv("OMPI_COMM_WORLD_RANK");
+        const char* size = std::getenv("OMPI_COMM_WORLD_SIZE");
+        if (!rank) rank = std::getenv("PMI_RANK");
+        if (!size) size = std::getenv("PMI_SIZE");
+        if (rank && size && std::atoi(size) > 1) {
+            pid_ = std::atoi(rank);
+            size_t dot = path_.rfind('.');
+            if (dot == std::string::npos || path_.find('/', dot) != std::string::npos) dot = path_.size();
+            path_.insert(dot, "." + std::string(rank));
+        }
+        active_.store(true, std::memory_order_relaxed);
+        std::atexit([] { instance().write(); });
+    }
+
+    static Recorder& instance() {
+        // Не разрушается: события OMPT могут приходить и во время завершения программы
+        static Recorder* recorder = new Recorder();
+        return *recorder;
+    }
+
+    bool active() const { return active_.load(std::memory_order_relaxed); }
+
+    uint64_t now() const {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - origin_)
+            .count();
+    }
+
+    // Буфер вызывающей нити; регистрируется при первом обращении
+    ThreadTrace& local(const char* threadName = nullptr) {
+        thread_local ThreadTrace* current = nullptr;
+        if (!current) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            threads_.emplace_back(new ThreadTrace());
+            current = threads_.back().get();
+            current->tid = (int)threads_.size() - 1;
+            current->name = (threadName ? threadName : "thread") + std::string(" ") + std::to_string(current->tid);
+        }
+        return *current;
+    }
+
+    void begin(const char* name, const char* category) {
+        ThreadTrace& thread = local();
+        if (thread.open.size() < kMaxOpen) thread.open.push_back({name, category, now(), 0});
+    }
+
+    // Закрытие ближайшего открытого интервала с тем же именем; keep = false — отбросить без записи
+    void end(const char* name, bool keep = true) {
+        ThreadTrace& thread = local();
+        for (size_t k = thread.open.size(); k-- > 0;) {
+            if (thread.open[k].name == name || std::strcmp(thread.open[k].name, name) == 0) {
+                Event event = thread.open[k];
+                event.duration = now() - event.start;
+                if (keep) thread.push(event);
+                thread.open.erase(thread.open.begin() + k);
+                return;
+            }
+        }
+    }
+
+    void write() {
+        if (!active_.exchange(false)) return;
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::ofstream out(path_);
+        if (!out) {
+            std::cerr << "Trace: cannot write " << path_ << "\n";
+            return;
+        }
+        size_t events = 0;
+        char buffer[64];
+        out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+        out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << pid_ << ",\"args\":{\"name\":\"" << pid_
+            << "\"}}";
+        for (const auto& thread : threads_) {
+            out << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << pid_ << ",\"tid\":" << thread->tid
+                << ",\"args\":{\"name\":\"" << thread->name << "\"}}";
+            for (size_t c = 0; c < thread->chunks.size(); ++c) {
+                const size_t count = c + 1 == thread->chunks.size() ? thread->used : kChunkEvents;
+                for (size_t k = 0; k < count; ++k) {
+                    const Event& event = thread->chunks[c][k];
+                    std::snprintf(buffer, sizeof(buffer), "\"ts\":%.3f,\"dur\":%.3f", event.start * 1e-3,
+                                  event.duration * 1e-3);
+                    out << ",\n{\"name\":\"" << event.name << "\",\"cat\":\"" << event.category
+                        << "\",\"ph\":\"X\"," << buffer << ",\"pid\":" << pid_ << ",\"tid\":" << thread->tid << "}";
+                }
+            }
+            events += thread->size();
+        }
+        out << "\n]}\n";
+        std::cerr << "Trace: " << events << " events from " << threads_.size() << " threads written to " << path_
+                  << "\n";
+    }
+
+    // События конструкций приходят от OMPT
+    bool runtimeEvents() const { return runtimeEvents_; }
+    void setRuntimeEvents() { runtimeEvents_ = true; }
+
+private:
+    std::chrono::steady_clock::time_point origin_;
+    std::atomic<bool> active_{false};
+    std::string path_;
+    int pid_ = 0;
+    std::mutex mutex_;
+    std::vector<std::unique_ptr<ThreadTrace>> threads_;
+    bool runtimeEvents_ = false;
+};
+
+inline bool enabled() { return Recorder::instance().active(); }
+
+inline bool recorded(Marker marker) {
+    Recorder& recorder = Recorder::instance();
+    return recorder.active() && (marker == Marker::Work || !recorder.runtimeEvents());
+}
+
+// Имена и категории — строковые литералы: хранится только указатель
+inline void begin(const char* name, const char* category = "work", Marker marker = Marker::Work) {
+    if (recorded(marker)) Recorder::instance().begin(name, category);
+}
+
+inline void end(const char* name, Marker marker = Marker::Work) {
+    if (recorded(marker)) Recorder::instance().end(name);
+}
+
+// #pragma omp barrier с маркером ожидания; вызывается внутри параллельной области
+inline void barrier() {
+    begin("barrier wait", "sync", Marker::Construct);
+#pragma omp barrier
+    end("barrier wait", Marker::Construct);
+}
+
+} // namespace trace
+
+#ifdef TRACE_OMPT
+namespace trace {
+namespace ompt {
+
+constexpr uint64_t kExplicitTask = 1;
+constexpr uint64_t kTaskRunning = 2;
+
+inline const char* workName(ompt_work_t kind) {
+    switch (kind) {
+    case ompt_work_loop: return "omp for";
+    case ompt_work_sections: return "sections";
+    case ompt_work_single_other: return "single (skipped)";
+    case ompt_work_taskloop: return "taskloop";
+    default: return "worksharing";
+    }
+}
+
+inline const char* syncName(ompt_sync_region_t kind) {
+    switch (kind) {
+    case ompt_sync_region_taskwait: return "taskwait";
+    case ompt_sync_region_taskgroup: return "taskgroup wait";
+    case ompt_sync_region_reduction: return "reduction wait";
+    default: return "barrier wait";
+    }
+}
+
+inline const char* mutexName(ompt_mutex_t kind, bool wait) {
+    switch (kind) {
+    case ompt_mutex_critical: return wait ? "critical wait" : "critical";
+    case ompt_mutex_ordered: return wait ? "ordered wait" : "ordered";
+    default: return wait ? "lock wait" : "lock";
+    }
+}
+
+inline void scope(ompt_scope_endpoint_t endpoint, const char* name, const char* category) {
+    Recorder& recorder = Recorder::instance();
+    if (!recorder.active()) return;
+    if (endpoint == ompt_scope_begin) recorder.begin(name, category);
+    else recorder.end(name);
+}
+
+inline void onThreadBegin(ompt_thread_t type, ompt_data_t*) {
+    if (Recorder::instance().active()) Recorder::instance().local(type == ompt_thread_initial ? "initial" : "worker");
+}
+
+// Участие нити в параллельной области
+inline void onImplicitTask(ompt_scope_endpoint_t endpoint, ompt_data_t*, ompt_data_t*, unsigned int, unsigned int,
+                           int flags) {
+    if (!(flags & ompt_task_initial)) scope(endpoint, "parallel", "parallel");
+}
+
+// Конец single у исполнителя через интерфейс GOMP_* (код g++) не сообщается, такие single пропускаются
+inline void onWork(ompt_work_t kind, ompt_scope_endpoint_t endpoint, ompt_data_t*, ompt_data_t*, uint64_t,
+                   const void*) {
+    if (kind != ompt_work_single_executor) scope(endpoint, workName(kind), "worksharing");
+}
+
+inline void onSyncWait(ompt_sync_region_t kind, ompt_scope_endpoint_t endpoint, ompt_data_t*, ompt_data_t*,
+                       const void*) {
+    scope(endpoint, syncName(kind), "sync");
+}
+
+// Нить ждёт не больше одного замка за раз. Неудачная попытка omp_test_lock сообщает acquire
+// (libomp — с видом ompt_mutex_lock), но не acquired, поэтому открытое ожидание, которое застал
+// следующий acquire, принадлежит такой попытке и отбрасывается без записи.
+inline const char*& pendingWait() {
+    thread_local const char* name = nullptr;
+    return name;
+}
+
+inline void onMutexAcquire(ompt_mutex_t kind, unsigned int, unsigned int, ompt_wait_id_t, const void*) {
+    Recorder& recorder = Recorder::instance();
+    if (kind == ompt_mutex_atomic || !recorder.active()) return;
+    const char*& pending = pendingWait();
+    if (pending) recorder.end(pending, false);
+    pending = mutexName(kind, true);
+    recorder.begin(pending, "sync");
+}
+
+inline void onMutexAcquired(ompt_mutex_t kind, ompt_wait_id_t, const void*) {
+    if (kind == ompt_mutex_atomic) return;
+    const char*& pending = pendingWait();
+    if (pending) scope(ompt_scope_end, pending, "sync");
+    pending = nullptr;
+    scope(ompt_scope_begin, mutexName(kind, false), "sync");
+}
+
+inline void onMutexReleased(ompt_mutex_t kind, ompt_wait_id_t, const void*) {
+    if (kind != ompt_mutex_atomic) scope(ompt_scope_end, mutexName(kind, false), "sync");
+}
+
+// Явные задачи: интервал от первого запуска до завершения (приостановки в taskwait — внутри него)
+inline void onTaskCreate(ompt_data_t*, const ompt_frame_t*, ompt_data_t* task, int flags, int, const void*) {
+    task->value = (flags & ompt_task_explicit) ? kExplicitTask : 0;
+}
+
+inline void onTaskSchedule(ompt_data_t* prior, ompt_task_status_t status, ompt_data_t* next) {
+    if (prior && (prior->value & kExplicitTask) &&
+        (status == ompt_task_complete || status == ompt_task_cancel || status == ompt_task_detach)) {
+        scope(ompt_scope_end, "task", "task");
+    }
+    if (next && (next->value & kExplicitTask) && !(next->value & kTaskRunning)) {
+        next->value |= kTaskRunning;
+        scope(ompt_scope_begin, "task", "task");
+    }
+}
+
+inline int initialize(ompt_function_lookup_t lookup, int, ompt_data_t*) {
+    auto setCallback = reinterpret_cast<ompt_set_callback_t>(lookup("ompt_set_callback"));
+    if (!setCallback) return 0;
+    setCallback(ompt_callback_thread_begin, reinterpret_cast<ompt_callback_t>(onThreadBegin));
+    setCallback(ompt_callback_implicit_task, reinterpret_cast<ompt_callback_t>(onImplicitTask));
+    setCallback(ompt_callback_work, reinterpret_cast<ompt_callback_t>(onWork));
+    setCallback(ompt_callback_sync_region_wait, reinterpret_cast<ompt_callback_t>(onSyncWait));
+    setCallback(ompt_callback_mutex_acquire, reinterpret_cast<ompt_callback_t>(onMutexAcquire));
+    setCallback(ompt_callback_mutex_acquired, reinterpret_cast<ompt_callback_t>(onMutexAcquired));
+    setCallback(ompt_callback_mutex_released, reinterpret_cast<ompt_callback_t>(onMutexReleased));
+    setCallback(ompt_callback_task_create, reinterpret_cast<ompt_callback_t>(onTaskCreate));
+    setCallback(ompt_callback_task_schedule, reinterpret_cast<ompt_callback_t>(onTaskSchedule));
+    Recorder::instance().setRuntimeEvents();
+    return 1;
+}
+
+inline void finalize(ompt_data_t*) {}
+
+} // namespace ompt
+} // namespace trace
+
+// Вызывается libomp при запуске; без TRACE_FILE инструмент не активируется и не стоит ничего
+extern "C" ompt_start_tool_result_t* ompt_start_tool(unsigned int, const char*) {
+    static ompt_start_tool_result_t result = {trace::ompt::initialize, trace::ompt::finalize, {0}};
+    return trace::enabled() ? &result : nullptr;
+}
+#endif // TRACE_OMPT
+
+// Интервал работы нити на время жизни объекта
+class TraceScope {
+public:
+    explicit TraceScope(const char* name, const char* category = "work", trace::Marker marker = trace::Marker::Work)
+        : name_(name), marker_(marker) {
+        trace::begin(name, category, marker);
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+    ~TraceScope() { trace::end(name_, marker_); }
+
+private:
+    const char* name_;
+    trace::Marker marker_;
+};
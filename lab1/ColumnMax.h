@@ -0,0 +1,46 @@
+#pragma once
+
+#include <vector>
+#include <omp.h>
+
+// Исходные ядра поиска максимумов в столбцах матрицы vector<vector<int>>
+
+// Функция для поиска максимальных элементов в столбцах без распараллеливания
+inline std::vector<int> findMaxInColumnsSequential(const std::vector<std::vector<int>>& matrix) {
+    int m = matrix.size();
+    int n = matrix[0].size();
+    std::vector<int> maxElements(n);
+
+    for (int j = 0; j < n; ++j) {
+        maxElements[j] = matrix[0][j];
+        for (int i = 1; i < m; ++i) {
+            if (matrix[i][j] > maxElements[j]) {
+                maxElements[j] = matrix[i][j];
+            }
+        }
+    }
+
+    return maxElements;
+}
+
+// Функция для поиска максимальных элементов в столбцах с распараллеливанием OpenMP
+inline std::vector<int> findMaxInColumnsParallel(const std::vector<std::vector<int>>& matrix) {
+    int m = matrix.size();
+    int n = matrix[0].size();
+    std::vector<int> maxElements(n);
+
+#pragma omp parallel for
+    for (int j = 0; j < n; ++j) {
+        int max_val = matrix[0][j];
+        for (int i = 1; i < m; ++i) {
+            if (matrix[i][j] > max_val) {
+                max_val = matrix[i][j];
+            }
+        }
+        maxElements[j] = max_val;
+        /*int threads = omp_get_num_threads();
+        printf("threads=%d\n", threads);*/
+    }
+
+    return maxElements;
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstdio>
+#include <memory>
+#include <vector>
+#include <mpi.h>
+
+#include "../common/Matrix.h"
+#include "../common/MatrixGenerator.h"
+#include "ColumnMaxSimd.h"
+
+// Гибридный режим MPI+OpenMP: матрица m×n делится между процессами по блокам строк.
+// Каждый процесс сам генерирует свой блок (или отображает в память свою часть файла), ищет локальные максимумы OpenMP-ядром
+// findMaxInColumnsSimd, после чего результаты сводятся операцией MPI_MAX на процесс 0.
+
+// Запуск распределённого поиска; вызывается между MPI_Init и MPI_Finalize.
+// Если задан path, матрица берётся из файла, а m и n игнорируются.
+inline void runDistributedColumnMax(long long m, int n, const char* path = nullptr) {
+    int rank = 0, size = 1;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    std::unique_ptr<MappedMatrixFile> file;
+    if (path) {
+        file.reset(new MappedMatrixFile(path));
+        m = file->rows();
+        n = file->cols();
+    }
+
+    // Блок строк текущего процесса
+    long long rowBegin = m * rank / size;
+    long long rowEnd = m * (rank + 1) / size;
+    Matrix<int> block;
+    if (!file) {
+        block = Matrix<int>(rowEnd - rowBegin, n);
+        generateRowBlock(block, rowBegin);
+    }
+
+    MPI_Barrier(MPI_COMM_WORLD);
+
+    // Локальные вычисления
+    double startCompute = MPI_Wtime();
+    std::vector<int> localMax = file ? findMaxInColumnsMapped(*file, rowBegin, rowEnd)
+                                     : findMaxInColumnsSimd(block);
+    double computeTime = MPI_Wtime() - startCompute;
+
+    // Сведение результатов
+    double startComm = MPI_Wtime();
+    std::vector<int> globalMax(rank == 0 ? n : 0);
+    MPI_Reduce(localMax.data(), globalMax.data(), n, MPI_INT, MPI_MAX, 0, MPI_COMM_WORLD);
+    double commTime = MPI_Wtime() - startComm;
+
+    // Сбор статистики по процессам
+    double local[3] = {(double)(rowEnd - rowBegin), computeTime, commTime};
+    std::vector<double> all(rank == 0 ? 3 * size : 0);
+    MPI_Gather(local, 3, MPI_DOUBLE, all.data(), 3, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+
+    if (rank == 0) {
+        printf("MPI ranks: %d, OpenMP threads per rank: %d, matrix %lld x %d\n",
+               size, omp_get_max_threads(), m, n);
+        for (int r = 0; r < size; ++r) {
+            printf("Rank %d: rows=%.0f compute=%.0f ns comm=%.0f ns\n",
+                   r, all[3 * r], all[3 * r + 1] * 1e9, all[3 * r + 2] * 1e9);
+        }
+        if (n <= 20) {
+            printf("Max elements in columns (MPI):\n");
+            for (int j = 0; j < n; ++j) printf("%d ", globalMax[j]);
+            printf("\n");
+        }
+
+        // Для небольших сгенерированных матриц сверяемся с последовательным проходом
+        if (!file && m * n <= 50000000LL) {
+            Matrix<int> full(m, n);
+            generateRowBlock(full, 0);
+            bool correct = true;
+            for (int j = 0; j < n && correct; ++j) {
+                int value = full(0, j);
+                for (long long i = 1; i < m; ++i) value = std::max(value, full(i, j));
+                correct = value == globalMax[j];
+            }
+            printf(correct ? "Results are consistent.\n" : "Results are inconsistent.\n");
+        }
+    }
+}
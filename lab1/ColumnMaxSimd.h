@@ -0,0 +1,162 @@
+#pragma once
+
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include <omp.h>
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include "../common/Matrix.h"
+#include "../common/MatrixFile.h"
+#include "../common/Trace.h"
+
+// Поиск максимальных элементов в столбцах плотной матрицы с потоковым проходом по строкам.
+//
+// Каждая нить получает непрерывный блок строк. Блок обрабатывается плитками по
+// несколько строк: для каждой панели из kPanelVectors SIMD-векторов текущие
+// максимумы держатся в регистрах, пока плитка проходится сверху вниз, и только
+// потом сбрасываются в локальный массив нити. Локальные массивы сливаются
+// параллельно по столбцам, без критических секций.
+
+namespace column_max_simd {
+
+// Набор SIMD-операций над int32 для текущей архитектуры
+#if defined(__AVX512F__)
+struct SimdInt32 {
+    using Vec = __m512i;
+    static constexpr size_t kLanes = 16;
+    static const char* name() { return "AVX-512"; }
+    static Vec load(const int* p) { return _mm512_loadu_si512(p); }
+    static void store(int* p, Vec v) { _mm512_storeu_si512(p, v); }
+    static Vec max(Vec a, Vec b) { return _mm512_max_epi32(a, b); }
+};
+#elif defined(__AVX2__)
+struct SimdInt32 {
+    using Vec = __m256i;
+    static constexpr size_t kLanes = 8;
+    static const char* name() { return "AVX2"; }
+    static Vec load(const int* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+    static void store(int* p, Vec v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+    static Vec max(Vec a, Vec b) { return _mm256_max_epi32(a, b); }
+};
+#else
+struct SimdInt32 {
+    using Vec = int;
+    static constexpr size_t kLanes = 1;
+    static const char* name() { return "scalar"; }
+    static Vec load(const int* p) { return *p; }
+    static void store(int* p, Vec v) { *p = v; }
+    static Vec max(Vec a, Vec b) { return a > b ? a : b; }
+};
+#endif
+
+// Количество векторов-аккумуляторов в одной панели столбцов
+constexpr size_t kPanelVectors = 4;
+// Примерный объём одной плитки строк (порядка L2-кэша)
+constexpr size_t kTileBytes = 256 * 1024;
+
+// Свёртка строк [rowBegin, rowEnd) в массив текущих максимумов acc длины cols
+inline void foldRows(const MatrixView<int>& matrix, size_t rowBegin, size_t rowEnd, int* acc) {
+    using S = SimdInt32;
+    constexpr size_t panel = kPanelVectors * S::kLanes;
+    const size_t n = matrix.cols();
+    const size_t rowBytes = std::max<size_t>(1, matrix.stride() * sizeof(int));
+    const size_t tileRows = std::min<size_t>(512, std::max<size_t>(4, kTileBytes / rowBytes));
+
+    for (size_t tile = rowBegin; tile < rowEnd; tile += tileRows) {
+        const size_t tileEnd = std::min(tile + tileRows, rowEnd);
+        size_t j = 0;
+
+        // Полные панели: максимумы живут в регистрах на протяжении всей плитки
+        for (; j + panel <= n; j += panel) {
+            typename S::Vec v[kPanelVectors];
+            for (size_t k = 0; k < kPanelVectors; ++k) v[k] = S::load(acc + j + k * S::kLanes);
+            for (size_t i = tile; i < tileEnd; ++i) {
+                const int* row = matrix.row(i) + j;
+                for (size_t k = 0; k < kPanelVectors; ++k) {
+                    v[k] = S::max(v[k], S::load(row + k * S::kLanes));
+                }
+            }
+            for (size_t k = 0; k < kPanelVectors; ++k) S::store(acc + j + k * S::kLanes, v[k]);
+        }
+
+        // Остаток по одному вектору
+        for (; j + S::kLanes <= n; j += S::kLanes) {
+            typename S::Vec v = S::load(acc + j);
+            for (size_t i = tile; i < tileEnd; ++i) v = S::max(v, S::load(matrix.row(i) + j));
+            S::store(acc + j, v);
+        }
+
+        // Скалярный хвост
+        for (; j < n; ++j) {
+            int value = acc[j];
+            for (size_t i = tile; i < tileEnd; ++i) value = std::max(value, matrix(i, j));
+            acc[j] = value;
+        }
+    }
+}
+
+} // namespace column_max_simd
+
+// Параллельный поиск максимумов в столбцах: блоки строк по нитям + редукция по столбцам
+inline std::vector<int> findMaxInColumnsSimd(const MatrixView<int>& matrix) {
+    const size_t m = matrix.rows();
+    const size_t n = matrix.cols();
+    std::vector<int> maxElements(n, INT_MIN);
+    if (m == 0 || n == 0) return maxElements;
+
+    const int maxThreads = omp_get_max_threads();
+    // Локальные максимумы нитей; память без инициализации, первое касание делает владелец
+    std::unique_ptr<int[]> partial(new int[static_cast<size_t>(maxThreads) * n]);
+    int usedThreads = 1;
+
+#pragma omp parallel
+    {
+        const int numThreads = omp_get_num_threads();
+        const int threadId = omp_get_thread_num();
+#pragma omp single
+        usedThreads = numThreads;
+
+        int* local = partial.get() + static_cast<size_t>(threadId) * n;
+        std::fill(local, local + n, INT_MIN);
+
+        const size_t rowBegin = m * threadId / numThreads;
+        const size_t rowEnd = m * (threadId + 1) / numThreads;
+        {
+            TraceScope fold("foldRows");
+            column_max_simd::foldRows(matrix, rowBegin, rowEnd, local);
+        }
+
+        trace::barrier();
+        // Редукция: каждая нить сводит свой диапазон столбцов по всем локальным массивам
+#pragma omp for schedule(static)
+        for (size_t j = 0; j < n; ++j) {
+            int value = partial[j];
+            for (int t = 1; t < usedThreads; ++t) {
+                value = std::max(value, partial[static_cast<size_t>(t) * n + j]);
+            }
+            maxElements[j] = value;
+        }
+    }
+
+    return maxElements;
+}
+
+// Поиск максимумов в столбцах по строкам [rowBegin, rowEnd) матрицы из отображённого в память файла.
+// Файл проходится порциями по chunkBytes байт, поэтому в памяти одновременно
+// находится лишь пара порций, даже если матрица больше оперативной памяти.
+inline std::vector<int> findMaxInColumnsMapped(const MappedMatrixFile& file, size_t rowBegin = 0,
+                                               size_t rowEnd = SIZE_MAX, size_t chunkBytes = 64u << 20) {
+    std::vector<int> maxElements(file.cols(), INT_MIN);
+    forEachRowChunk<int>(file, chunkBytes, [&](const MatrixView<int>& chunk, size_t) {
+        std::vector<int> chunkMax = findMaxInColumnsSimd(chunk);
+        for (size_t j = 0; j < chunkMax.size(); ++j) maxElements[j] = std::max(maxElements[j], chunkMax[j]);
+    }, rowBegin, rowEnd);
+    return maxElements;
+}
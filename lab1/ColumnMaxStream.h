@@ -0,0 +1,305 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <istream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <omp.h>
+
+#include "../common/Matrix.h"
+#include "../common/MatrixFile.h"
+#include "ColumnMaxSimd.h"
+
+// Максимумы в столбцах матрицы, строки которой приходят потоком (канал, сокет, файл).
+//
+// Отдельная нить чтения разбирает строки в кольцо из нескольких блоков по blockRows строк,
+// а команда нитей OpenMP сворачивает очередной заполненный блок в текущие максимумы,
+// пока читается следующий: ввод и вычисления перекрываются, а в памяти одновременно
+// находятся только блоки кольца, сколько бы строк ни было в потоке. Блок сворачивается
+// ядром column_max_simd::foldRows. Если полос столбцов не меньше, чем нитей, нити берут
+// полосы целиком и пишут прямо в общий массив максимумов. В узком блоке полос на всех
+// не хватает, поэтому строки блока ещё делятся на диапазоны: каждая пара (диапазон, полоса)
+// сворачивается в частичные максимумы своего диапазона, которые затем сливаются по столбцам.
+// После каждого блока максимумы публикуются под мьютексом: snapshot() можно вызывать
+// из любой нити в любой момент, после окончания потока он даёт окончательный результат.
+
+// Чтение строк в текстовом виде: по строке матрицы на строку текста, числа через пробел.
+// Число столбцов задаёт первая непустая строка.
+class TextRowReader {
+public:
+    explicit TextRowReader(std::istream& in) : in_(in) {
+        // Пустые строки в начале пропускаются так же, как в середине потока
+        while (std::getline(in_, pending_)) {
+            parse(pending_, values_);
+            if (!values_.empty()) {
+                cols_ = values_.size();
+                hasPending_ = true;
+                return;
+            }
+            ++lineNumber_;
+        }
+    }
+
+    size_t cols() const { return cols_; }
+
+    // Заполнить до block.rows() строк блока; возвращает число прочитанных строк (0 — конец потока)
+    size_t read(Matrix<int>& block) {
+        size_t rows = 0;
+        if (hasPending_) {
+            std::copy(values_.begin(), values_.end(), block.row(rows++));
+            hasPending_ = false;
+        }
+        while (rows < block.rows() && std::getline(in_, line_)) {
+            ++lineNumber_;
+            parse(line_, values_);
+            if (values_.empty()) continue;
+            if (values_.size() != cols_) {
+                throw std::runtime_error("Row " + std::to_string(lineNumber_) + " has " +
+                                         std::to_string(values_.size()) + " values, expected " +
+                                         std::to_string(cols_));
+            }
+            std::copy(values_.begin(), values_.end(), block.row(rows++));
+        }
+        return rows;
+    }
+
+private:
+    void parse(const std::string& line, std::vector<int>& values) {
+        values.clear();
+        const char* p = line.c_str();
+        while (true) {
+            char* end = nullptr;
+            long value = std::strtol(p, &end, 10);
+            if (end == p) break;
+            values.push_back(static_cast<int>(value));
+            p = end;
+        }
+        while (*p == ' ' || *p == '\t' || *p == '\r') ++p;
+        if (*p) throw std::runtime_error("Bad number in row " + std::to_string(lineNumber_));
+    }
+
+    std::istream& in_;
+    std::string line_;
+    std::string pending_;
+    std::vector<int> values_;
+    size_t cols_ = 0;
+    size_t lineNumber_ = 1;
+    bool hasPending_ = false;
+};
+
+// Чтение строк в двоичном формате common/MatrixFile.h (int32) последовательно, без mmap,
+// поэтому источником может быть канал
+class BinaryRowReader {
+public:
+    explicit BinaryRowReader(std::istream& in) : in_(in) {
+        if (!in_.read(reinterpret_cast<char*>(&header_), sizeof(header_)) ||
+            std::memcmp(header_.magic, kMatrixFileMagic, sizeof(kMatrixFileMagic)) != 0) {
+            throw std::runtime_error("Bad matrix stream header");
+        }
+        if (header_.elementType != static_cast<uint32_t>(MatrixElementType::Int32)) {
+            throw std::runtime_error("Matrix stream element type must be int32");
+        }
+        if (header_.stride < header_.cols || header_.dataOffset < sizeof(header_)) {
+            throw std::runtime_error("Bad matrix stream layout");
+        }
+        in_.ignore(header_.dataOffset - sizeof(header_));
+        padding_.resize((header_.stride - header_.cols) * sizeof(int));
+    }
+
+    size_t cols() const { return header_.cols; }
+
+    size_t read(Matrix<int>& block) {
+        size_t rows = 0;
+        while (rows < block.rows() && rowsRead_ < header_.rows) {
+            if (!in_.read(reinterpret_cast<char*>(block.row(rows)), header_.cols * sizeof(int)) ||
+                !in_.read(padding_.data(), padding_.size())) {
+                throw std::runtime_error("Matrix stream is truncated at row " + std::to_string(rowsRead_));
+            }
+            ++rows;
+            ++rowsRead_;
+        }
+        return rows;
+    }
+
+private:
+    std::istream& in_;
+    MatrixFileHeader header_{};
+    std::vector<char> padding_;
+    size_t rowsRead_ = 0;
+};
+
+// Сводка о перекрытии ввода и вычислений
+struct StreamStats {
+    size_t rows = 0;
+    size_t blocks = 0;
+    double readerWait = 0.0;  // нить чтения ждала свободный блок (упор в вычисления)
+    double computeWait = 0.0; // вычисления ждали заполненный блок (упор в ввод)
+    double computeTime = 0.0;
+};
+
+class StreamingColumnMax {
+public:
+    // Столбцы полосы, которую нить сворачивает целиком (кратно ширине SIMD-панели)
+    static constexpr size_t kColumnStrip = 256;
+
+    explicit StreamingColumnMax(size_t cols) : acc_(cols, INT_MIN), published_(cols, INT_MIN) {}
+
+    // Текущие максимумы и число учтённых строк; потокобезопасно
+    std::vector<int> snapshot(size_t* rows = nullptr, bool* finished = nullptr) const {
+        std::lock_guard<std::mutex> lock(publishMutex_);
+        if (rows) *rows = publishedRows_;
+        if (finished) *finished = finished_;
+        return published_;
+    }
+
+    // Чтение потока reader (TextRowReader / BinaryRowReader) кольцом из slots блоков по blockRows строк.
+    // onBlock(rowsSoFar) вызывается после каждого свёрнутого блока.
+    template <typename Reader, typename OnBlock>
+    StreamStats run(Reader& reader, size_t blockRows, size_t slots, OnBlock onBlock) {
+        using Clock = std::chrono::steady_clock;
+        const size_t n = acc_.size();
+        slots = std::max<size_t>(2, slots);
+        std::vector<Matrix<int>> ring;
+        for (size_t s = 0; s < slots; ++s) ring.emplace_back(blockRows, n);
+        std::vector<size_t> filledRows(slots, 0);
+
+        std::mutex mutex;
+        std::condition_variable changed;
+        size_t filled = 0; // заполненных блоков, ждущих свёртки
+        bool end = false;
+        std::exception_ptr error;
+        StreamStats stats;
+
+        std::thread readerThread([&] {
+            size_t head = 0;
+            while (true) {
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    auto waitStart = Clock::now();
+                    changed.wait(lock, [&] { return filled < slots; });
+                    stats.readerWait += std::chrono::duration<double>(Clock::now() - waitStart).count();
+                }
+                size_t rows = 0;
+                try {
+                    rows = reader.read(ring[head]);
+                }
+                catch (...) {
+                    error = std::current_exception();
+                }
+                std::lock_guard<std::mutex> lock(mutex);
+                if (rows > 0 && !error) {
+                    filledRows[head] = rows;
+                    head = (head + 1) % slots;
+                    ++filled;
+                }
+                if (rows < blockRows || error) end = true;
+                changed.notify_all();
+                if (end) return;
+            }
+        });
+
+        size_t tail = 0;
+        while (true) {
+            size_t rows;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                auto waitStart = Clock::now();
+                changed.wait(lock, [&] { return filled > 0 || end; });
+                stats.computeWait += std::chrono::duration<double>(Clock::now() - waitStart).count();
+                if (filled == 0) break;
+                rows = filledRows[tail];
+            }
+
+            auto computeStart = Clock::now();
+            foldBlock(MatrixView<int>(ring[tail]).rowRange(0, rows));
+            stats.computeTime += std::chrono::duration<double>(Clock::now() - computeStart).count();
+            stats.rows += rows;
+            ++stats.blocks;
+            publish(stats.rows, false);
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                tail = (tail + 1) % slots;
+                --filled;
+            }
+            changed.notify_all();
+            onBlock(stats.rows);
+        }
+
+        readerThread.join();
+        publish(stats.rows, true);
+        if (error) std::rethrow_exception(error);
+        return stats;
+    }
+
+    template <typename Reader>
+    StreamStats run(Reader& reader, size_t blockRows, size_t slots = 3) {
+        return run(reader, blockRows, slots, [](size_t) {});
+    }
+
+private:
+    // Свёртка блока в acc_: нити берут полосы столбцов и проходят все строки блока
+    void foldBlock(const MatrixView<int>& block) {
+        const size_t n = block.cols();
+        const size_t rows = block.rows();
+        const long long strips = (n + kColumnStrip - 1) / kColumnStrip;
+        const long long bands = std::min<long long>(std::max<long long>(1, omp_get_max_threads() / strips), rows);
+        if (bands <= 1) {
+#pragma omp parallel for schedule(static)
+            for (long long s = 0; s < strips; ++s) {
+                const size_t j0 = s * kColumnStrip;
+                const size_t width = std::min(kColumnStrip, n - j0);
+                MatrixView<int> strip(block.row(0) + j0, rows, width, block.stride());
+                column_max_simd::foldRows(strip, 0, rows, acc_.data() + j0);
+            }
+            return;
+        }
+
+        // Узкий блок: диапазон строк r сворачивается в partial_[r * n, (r + 1) * n)
+        partial_.resize(bands * n);
+#pragma omp parallel
+        {
+#pragma omp for collapse(2) schedule(static)
+            for (long long r = 0; r < bands; ++r) {
+                for (long long s = 0; s < strips; ++s) {
+                    const size_t j0 = s * kColumnStrip;
+                    const size_t width = std::min(kColumnStrip, n - j0);
+                    int* local = partial_.data() + r * n + j0;
+                    std::fill(local, local + width, INT_MIN);
+                    MatrixView<int> strip(block.row(0) + j0, rows, width, block.stride());
+                    column_max_simd::foldRows(strip, rows * r / bands, rows * (r + 1) / bands, local);
+                }
+            }
+#pragma omp for schedule(static)
+            for (long long j = 0; j < (long long)n; ++j) {
+                int value = acc_[j];
+                for (long long r = 0; r < bands; ++r) value = std::max(value, partial_[r * n + j]);
+                acc_[j] = value;
+            }
+        }
+    }
+
+    void publish(size_t rows, bool finished) {
+        std::lock_guard<std::mutex> lock(publishMutex_);
+        std::copy(acc_.begin(), acc_.end(), published_.begin());
+        publishedRows_ = rows;
+        finished_ = finished;
+    }
+
+    std::vector<int> acc_;
+    std::vector<int> partial_; // частичные максимумы диапазонов строк узкого блока
+    mutable std::mutex publishMutex_;
+    std::vector<int> published_;
+    size_t publishedRows_ = 0;
+    bool finished_ = false;
+};
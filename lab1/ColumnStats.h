@@ -0,0 +1,226 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <type_traits>
+#include <vector>
+#include <omp.h>
+
+#include "../common/Matrix.h"
+
+// Несколько статистик по столбцам за один проход по матрице.
+//
+// Набор статистик — битовая маска Stats (column_stats::Min | Max | ArgMax | Sum | TopK),
+// заданная параметром шаблона: ненужные ветви убираются if constexpr, и для каждой
+// комбинации и типа элемента компилятор строит свой векторизованный цикл по столбцам
+// (ширина SIMD выбирается флагами компилятора). Поэтому новая статистика добавляет
+// к проходу несколько инструкций, а не ещё одно чтение матрицы из памяти.
+//
+// Как и в findMaxInColumnsSimd, нити получают непрерывные блоки строк и копят
+// локальные статистики, а затем сливают их параллельно по столбцам. Блок проходится
+// плитками kTileRows×kTileCols, чтобы аккумуляторы плитки оставались в L1.
+// Поддерживаемые типы: int8_t, int16_t, int32_t, float, double.
+
+namespace column_stats {
+
+enum : unsigned {
+    Min = 1,
+    Max = 2,
+    ArgMax = 4,  // номер первой строки с максимумом
+    Sum = 8,
+    TopK = 16,   // k наибольших значений столбца по убыванию
+    All = Min | Max | ArgMax | Sum | TopK
+};
+
+// Тип суммы: целые складываются в int64_t, вещественные — в double
+template <typename T>
+using SumType = typename std::conditional<std::is_integral<T>::value, int64_t, double>::type;
+
+constexpr size_t kTileRows = 64;
+constexpr size_t kTileCols = 512;
+constexpr size_t kTopGroup = 64;
+
+// Вставка value в отсортированный по возрастанию массив top из k элементов (top[0] — k-й по величине)
+template <typename T>
+void insertTop(T* top, size_t k, T value) {
+    size_t r = 0;
+    while (r + 1 < k && top[r + 1] < value) {
+        top[r] = top[r + 1];
+        ++r;
+    }
+    top[r] = value;
+}
+
+// Локальные статистики нити
+template <typename T>
+struct Partial {
+    size_t rows = 0;
+    std::vector<T> min, max;
+    std::vector<size_t> argmax;
+    std::vector<SumType<T>> sum;
+    std::vector<T> top;  // по k значений на столбец, по возрастанию
+    std::vector<T> kth;  // top[j * k] подряд, для векторной проверки порога
+
+    template <unsigned Stats>
+    void init(size_t n, size_t k, size_t rowBegin) {
+        if (Stats & Min) min.assign(n, std::numeric_limits<T>::max());
+        if (Stats & (Max | ArgMax)) max.assign(n, std::numeric_limits<T>::lowest());
+        if (Stats & ArgMax) argmax.assign(n, rowBegin);
+        if (Stats & Sum) sum.assign(n, 0);
+        if (Stats & TopK) {
+            top.assign(n * k, std::numeric_limits<T>::lowest());
+            kth.assign(n, std::numeric_limits<T>::lowest());
+        }
+    }
+};
+
+// Свёртка строк [rowBegin, rowEnd) в локальные статистики
+template <unsigned Stats, typename T>
+void foldRows(const MatrixView<T>& matrix, size_t rowBegin, size_t rowEnd, size_t k, Partial<T>& local) {
+    constexpr bool kElementwise = (Stats & (Min | Max | ArgMax | Sum)) != 0;
+    const size_t n = matrix.cols();
+    for (size_t tileRow = rowBegin; tileRow < rowEnd; tileRow += kTileRows) {
+        const size_t tileRowEnd = std::min(tileRow + kTileRows, rowEnd);
+        for (size_t tileCol = 0; tileCol < n; tileCol += kTileCols) {
+            const size_t width = std::min(kTileCols, n - tileCol);
+            T* __restrict mn = (Stats & Min) ? local.min.data() + tileCol : nullptr;
+            T* __restrict mx = (Stats & (Max | ArgMax)) ? local.max.data() + tileCol : nullptr;
+            size_t* __restrict am = (Stats & ArgMax) ? local.argmax.data() + tileCol : nullptr;
+            SumType<T>* __restrict sm = (Stats & Sum) ? local.sum.data() + tileCol : nullptr;
+
+            for (size_t i = tileRow; i < tileRowEnd; ++i) {
+                const T* __restrict row = matrix.row(i) + tileCol;
+                if constexpr (kElementwise) {
+#pragma omp simd
+                    for (size_t j = 0; j < width; ++j) {
+                        // Тернарные операторы вместо std::min/max: ссылка на v мешает векторизации
+                        const T v = row[j];
+                        if constexpr ((Stats & Min) != 0) mn[j] = v < mn[j] ? v : mn[j];
+                        if constexpr ((Stats & ArgMax) != 0) am[j] = v > mx[j] ? i : am[j];
+                        if constexpr ((Stats & (Max | ArgMax)) != 0) mx[j] = v > mx[j] ? v : mx[j];
+                        if constexpr ((Stats & Sum) != 0) sm[j] += static_cast<SumType<T>>(v);
+                    }
+                }
+                if constexpr ((Stats & TopK) != 0) {
+                    if (k == 0) continue; // top-k не запрошен: массивов top у нитей нет
+                    // Порог проверяется векторно группами по kTopGroup столбцов,
+                    // скалярная вставка выполняется только в группах с превышением
+                    T* kth = local.kth.data() + tileCol;
+                    for (size_t g = 0; g < width; g += kTopGroup) {
+                        const size_t groupEnd = std::min(g + kTopGroup, width);
+                        int above = 0;
+#pragma omp simd reduction(|:above)
+                        for (size_t j = g; j < groupEnd; ++j) above |= row[j] > kth[j];
+                        if (!above) continue;
+                        for (size_t j = g; j < groupEnd; ++j) {
+                            if (row[j] > kth[j]) {
+                                T* top = local.top.data() + (tileCol + j) * k;
+                                insertTop(top, k, row[j]);
+                                kth[j] = top[0];
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+} // namespace column_stats
+
+template <typename T>
+struct ColumnStatistics {
+    std::vector<T> min;
+    std::vector<T> max;
+    std::vector<size_t> argmax;
+    std::vector<column_stats::SumType<T>> sum;
+    size_t k = 0;        // число значений top на столбец: min(k, rows)
+    std::vector<T> top;  // top[j * k + r] — r-е по величине значение столбца j
+};
+
+// Статистики Stats по столбцам матрицы за один параллельный проход; k — размер top-k
+template <unsigned Stats, typename T>
+ColumnStatistics<T> computeColumnStatistics(const MatrixView<T>& matrix, size_t k = 0) {
+    static_assert(std::is_same<T, int8_t>::value || std::is_same<T, int16_t>::value ||
+                  std::is_same<T, int32_t>::value || std::is_same<T, float>::value ||
+                  std::is_same<T, double>::value, "unsupported element type");
+    using namespace column_stats;
+    const size_t m = matrix.rows();
+    const size_t n = matrix.cols();
+    if (!(Stats & TopK)) k = 0;
+
+    ColumnStatistics<T> result;
+    result.k = std::min(k, m);
+    if (Stats & Min) result.min.resize(n);
+    if (Stats & Max) result.max.resize(n);
+    if (Stats & ArgMax) result.argmax.resize(n);
+    if (Stats & Sum) result.sum.resize(n);
+    if (Stats & TopK) result.top.resize(n * result.k);
+    if (m == 0 || n == 0) return result;
+
+    std::vector<Partial<T>> partials(omp_get_max_threads());
+    int usedThreads = 1;
+
+#pragma omp parallel
+    {
+        const int numThreads = omp_get_num_threads();
+        const int threadId = omp_get_thread_num();
+#pragma omp single
+        usedThreads = numThreads;
+
+        // Локальные массивы выделяет и заполняет сама нить (первое касание)
+        const size_t rowBegin = m * threadId / numThreads;
+        const size_t rowEnd = m * (threadId + 1) / numThreads;
+        Partial<T>& local = partials[threadId];
+        local.rows = rowEnd - rowBegin;
+        local.template init<Stats>(n, k, rowBegin);
+        foldRows<Stats>(matrix, rowBegin, rowEnd, k, local);
+
+#pragma omp barrier
+        // Слияние по столбцам; нити перебираются по возрастанию номеров строк,
+        // поэтому при равных максимумах остаётся первая строка
+        std::vector<T> candidates;
+#pragma omp for schedule(static)
+        for (size_t j = 0; j < n; ++j) {
+            bool first = true;
+            for (int t = 0; t < usedThreads; ++t) {
+                const Partial<T>& p = partials[t];
+                if (p.rows == 0) continue;
+                if constexpr ((Stats & Min) != 0) result.min[j] = first ? p.min[j] : std::min(result.min[j], p.min[j]);
+                if constexpr ((Stats & Sum) != 0) result.sum[j] = (first ? 0 : result.sum[j]) + p.sum[j];
+                first = false;
+            }
+            if constexpr ((Stats & (Max | ArgMax)) != 0) {
+                T best = std::numeric_limits<T>::lowest();
+                size_t bestRow = 0;
+                bool found = false;
+                for (int t = 0; t < usedThreads; ++t) {
+                    const Partial<T>& p = partials[t];
+                    if (p.rows == 0) continue;
+                    if (!found || p.max[j] > best) {
+                        best = p.max[j];
+                        if constexpr ((Stats & ArgMax) != 0) bestRow = p.argmax[j];
+                        found = true;
+                    }
+                }
+                if constexpr ((Stats & Max) != 0) result.max[j] = best;
+                if constexpr ((Stats & ArgMax) != 0) result.argmax[j] = bestRow;
+            }
+            if constexpr ((Stats & TopK) != 0) {
+                candidates.clear();
+                for (int t = 0; t < usedThreads; ++t) {
+                    const Partial<T>& p = partials[t];
+                    candidates.insert(candidates.end(), p.top.begin() + j * k, p.top.begin() + (j + 1) * k);
+                }
+                std::partial_sort(candidates.begin(), candidates.begin() + result.k, candidates.end(),
+                                  std::greater<T>());
+                std::copy(candidates.begin(), candidates.begin() + result.k, result.top.begin() + j * result.k);
+            }
+        }
+    }
+
+    return result;
+}
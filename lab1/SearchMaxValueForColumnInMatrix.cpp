@@ -4,111 +4,288 @@
 #include <chrono>
 #include <omp.h>
 #include <stdio.h>
+#include <cstdlib>
+#include <cstring>
+#include <mpi.h>
+#include <fstream>
+#include <memory>
+
+#include "../common/MatrixGenerator.h"
+#include "../common/PerfCounters.h"
+#include "ColumnMax.h"
+#include "ColumnMaxMpi.h"
+#include "ColumnMaxStream.h"
+#include "ColumnMaxSimd.h"
+#include "ColumnStats.h"
 
 using namespace std;
 using namespace std::chrono;
 
-// Функция для поиска максимальных элементов в столбцах без распараллеливания
-vector<int> findMaxInColumnsSequential(const vector<vector<int>>& matrix) {
-    int m = matrix.size();
-    int n = matrix[0].size();
-    vector<int> maxElements(n);
-
-    for (int j = 0; j < n; ++j) {
-        maxElements[j] = matrix[0][j];
-        for (int i = 1; i < m; ++i) {
-            if (matrix[i][j] > maxElements[j]) {
-                maxElements[j] = matrix[i][j];
+// Поиск по матрице из двоичного файла (см. common/MatrixFile.h) без загрузки в память целиком
+int runFileMode(const char* path) {
+    try {
+        MappedMatrixFile file(path);
+        int n = file.cols();
+
+        auto start = high_resolution_clock::now();
+        vector<int> maxElements = findMaxInColumnsMapped(file);
+        auto end = high_resolution_clock::now();
+
+        cout << "Matrix file: " << path << " (" << file.rows() << " x " << n << ")" << endl;
+        cout << "Mapped streaming execution time: " << duration_cast<nanoseconds>(end - start).count() << " ns" << endl;
+        if (n <= 20) {
+            cout << "Max elements in columns (file):" << endl;
+            for (int i = 0; i < n; ++i) {
+                cout << maxElements[i] << " ";
             }
+            cout << endl;
         }
     }
-
-    return maxElements;
+    catch (const exception& e) {
+        cerr << e.what() << endl;
+        return -1;
+    }
+    return 0;
 }
 
-// Функция для поиска максимальных элементов в столбцах с распараллеливанием OpenMP
-vector<int> findMaxInColumnsParallel(const vector<vector<int>>& matrix) {
-    int m = matrix.size();
-    int n = matrix[0].size();
-    vector<int> maxElements(n);
-
-#pragma omp parallel for
-    for (int j = 0; j < n; ++j) {
-        int max_val = matrix[0][j];
-        for (int i = 1; i < m; ++i) {
-            if (matrix[i][j] > max_val) {
-                max_val = matrix[i][j];
-            }
+// Потоковый режим: строки читаются из файла или stdin (путь "-" или не задан) блоками,
+// которые сворачиваются в максимумы, пока читаются следующие
+template <typename Reader>
+int runStream(Reader& reader) {
+    const size_t n = reader.cols();
+    if (n == 0) {
+        cerr << "Empty matrix stream." << endl;
+        return -1;
+    }
+    // Блок около 4 МБ, в кольце три блока
+    const size_t blockRows = max<size_t>(1, (4u << 20) / (n * sizeof(int)));
+    const size_t slots = 3;
+    StreamingColumnMax stream(n);
+
+    auto start = steady_clock::now();
+    auto lastReport = start;
+    StreamStats stats = stream.run(reader, blockRows, slots, [&](size_t rows) {
+        // Промежуточный результат доступен во время чтения
+        auto now = steady_clock::now();
+        if (now - lastReport >= seconds(1)) {
+            lastReport = now;
+            vector<int> current = stream.snapshot();
+            cerr << "  " << rows << " rows, max of column 0 so far: " << current[0] << endl;
+        }
+    });
+    double elapsed = duration<double>(steady_clock::now() - start).count();
+    vector<int> maxElements = stream.snapshot();
+
+    cout << "Streamed matrix: " << stats.rows << " x " << n << " in " << stats.blocks << " blocks of " << blockRows
+         << " rows (" << slots << " buffers, " << slots * blockRows * n * sizeof(int) / (1 << 20) << " MB)" << endl;
+    cout << "Streaming time: " << elapsed << " s, " << stats.rows * n * sizeof(int) / elapsed / (1 << 20) << " MB/s"
+         << endl;
+    cout << "Compute: " << stats.computeTime << " s, waiting for input: " << stats.computeWait
+         << " s, reader waiting for buffers: " << stats.readerWait << " s" << endl;
+    if (n <= 20) {
+        cout << "Max elements in columns (stream):" << endl;
+        for (size_t j = 0; j < n; ++j) {
+            cout << maxElements[j] << " ";
         }
-        maxElements[j] = max_val;
-        /*int threads = omp_get_num_threads();
-        printf("threads=%d\n", threads);*/
+        cout << endl;
     }
+    return 0;
+}
 
-    return maxElements;
+int runStreamMode(bool binary, const char* path) {
+    ifstream file;
+    istream* in = &cin;
+    if (path && strcmp(path, "-") != 0) {
+        file.open(path, binary ? ios::binary : ios::in);
+        if (!file) {
+            cerr << "Cannot open file: " << path << endl;
+            return -1;
+        }
+        in = &file;
+    }
+    try {
+        if (binary) {
+            BinaryRowReader reader(*in);
+            return runStream(reader);
+        }
+        TextRowReader reader(*in);
+        return runStream(reader);
+    }
+    catch (const exception& e) {
+        cerr << e.what() << endl;
+        return -1;
+    }
 }
 
-int main() {
-    // Размеры матрицы
-    int m = 10;
-    int n = 10;
+int main(int argc, char* argv[]) {
+    // Поток строк: Program1 --stream [--binary] [path | -]
+    if (argc >= 2 && strcmp(argv[1], "--stream") == 0) {
+        bool binary = argc >= 3 && strcmp(argv[2], "--binary") == 0;
+        int pathArg = binary ? 3 : 2;
+        ios::sync_with_stdio(false);
+        return runStreamMode(binary, argc > pathArg ? argv[pathArg] : nullptr);
+    }
 
-    // Инициализация матрицы случайными числами
-    vector<vector<int>> matrix(m, vector<int>(n));
-    for (int i = 0; i < m; ++i) {
-        for (int j = 0; j < n; ++j) {
-            matrix[i][j] = rand() % 1000; // случайные числа от 0 до 999
+    // Распределённый режим: mpirun -np N Program1 --mpi m n | --mpi --file path
+    if (argc >= 2 && strcmp(argv[1], "--mpi") == 0) {
+        const char* path = argc >= 4 && strcmp(argv[2], "--file") == 0 ? argv[3] : nullptr;
+        long long rows = !path && argc >= 3 ? atoll(argv[2]) : 10000;
+        int cols = !path && argc >= 4 ? atoi(argv[3]) : 10000;
+        int provided = 0;
+        MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED, &provided);
+        int rank = 0;
+        MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+        if (rows <= 0 || cols <= 0) {
+            if (rank == 0) cerr << "Matrix size must be positive." << endl;
+            MPI_Finalize();
+            return -1;
         }
+        try {
+            runDistributedColumnMax(rows, cols, path);
+        }
+        catch (const exception& e) {
+            cerr << "Rank " << rank << ": " << e.what() << endl;
+            MPI_Abort(MPI_COMM_WORLD, -1);
+        }
+        MPI_Finalize();
+        return 0;
     }
 
-    cout << "Matrix:" << endl;
-    for (int i = 0; i < m; ++i) {
-        for (int j = 0; j < n; ++j) {
-            cout << matrix[i][j] << " ";
+    // Матрица из файла: Program1 --file path
+    if (argc >= 3 && strcmp(argv[1], "--file") == 0) {
+        return runFileMode(argv[2]);
+    }
+
+    // Размеры матрицы (можно передать аргументами: Program1 m n)
+    int m = 10;
+    int n = 10;
+    if (argc >= 3) {
+        m = atoi(argv[1]);
+        n = atoi(argv[2]);
+    }
+    if (m <= 0 || n <= 0) {
+        cerr << "Matrix size must be positive." << endl;
+        return -1;
+    }
+    // Большие матрицы не выводим целиком
+    bool printMatrix = m <= 20 && n <= 20;
+
+    // Инициализация матрицы случайными числами от 0 до 999 (параллельно, см. common/MatrixGenerator.h)
+    vector<vector<int>> matrix = generateNestedMatrix(m, n, 1000);
+
+    if (printMatrix) {
+        cout << "Matrix:" << endl;
+        for (int i = 0; i < m; ++i) {
+            for (int j = 0; j < n; ++j) {
+                cout << matrix[i][j] << " ";
+            }
+            cout << endl;
         }
         cout << endl;
     }
-    cout << endl;
+
+    // Та же матрица в непрерывном построчном представлении; строки заполняют нити,
+    // которые потом читают их в SIMD-ядре
+    Matrix<int> dense(m, n);
+    generateRowBlock(dense, 0, 1000);
 
     // Замер времени выполнения без распараллеливания
+    PerfRegion perfSequential("sequential");
     auto startSequential = high_resolution_clock::now();
     vector<int> maxElementsSequential = findMaxInColumnsSequential(matrix);
     auto endSequential = high_resolution_clock::now();
+    perfSequential.stop();
     auto durationSequential = duration_cast<nanoseconds>(endSequential - startSequential); // Изменил на nanoseconds
 
     // Замер времени выполнения с распараллеливанием
+    PerfRegion perfParallel("parallel");
     auto startParallel = high_resolution_clock::now();
     vector<int> maxElementsParallel = findMaxInColumnsParallel(matrix);
     auto endParallel = high_resolution_clock::now();
+    perfParallel.stop();
     auto durationParallel = duration_cast<nanoseconds>(endParallel - startParallel); // Изменил на nanoseconds
 
+    // Замер времени выполнения потокового SIMD-ядра на непрерывной матрице
+    PerfRegion perfSimd("simd");
+    auto startSimd = high_resolution_clock::now();
+    vector<int> maxElementsSimd = findMaxInColumnsSimd(dense);
+    auto endSimd = high_resolution_clock::now();
+    perfSimd.stop();
+    auto durationSimd = duration_cast<nanoseconds>(endSimd - startSimd);
+
     // Вывод результатов
+    const double elements = (double)m * n;
     cout << "Sequential execution time: " << durationSequential.count() << " ns" << endl; // Изменил единицу измерения
+    perfSequential.print(cout, elements);
     cout << "Parallel execution time: " << durationParallel.count() << " ns" << endl; // Изменил единицу измерения
+    perfParallel.print(cout, elements);
+    cout << "SIMD row-streaming execution time (" << column_max_simd::SimdInt32::name() << "): "
+         << durationSimd.count() << " ns" << endl;
+    perfSimd.print(cout, elements);
+    cout << "SIMD speedup over parallel: "
+         << (double)durationParallel.count() / max<long long>(1, durationSimd.count()) << "x" << endl;
 
-    // Вывод максимальных элементов в столбцах (последовательная версия)
-    cout << "Max elements in columns (sequential):" << endl;
-    for (int i = 0; i < n; ++i) {
-        cout << maxElementsSequential[i] << " ";
-    }
-    cout << endl;
+    // Min, max, argmax, сумма и top-3 по столбцам за один проход
+    const size_t topK = 3;
+    PerfRegion perfStats("fused stats");
+    auto startStats = high_resolution_clock::now();
+    ColumnStatistics<int> stats = computeColumnStatistics<column_stats::All>(MatrixView<int>(dense), topK);
+    auto endStats = high_resolution_clock::now();
+    perfStats.stop();
+    cout << "Fused column statistics (min, max, argmax, sum, top-" << topK << ") execution time: "
+         << duration_cast<nanoseconds>(endStats - startStats).count() << " ns" << endl;
+    perfStats.print(cout, elements);
 
-    // Вывод максимальных элементов в столбцах (параллельная версия)
-    cout << "Max elements in columns (parallel):" << endl;
-    for (int i = 0; i < n; ++i) {
-        cout << maxElementsParallel[i] << " ";
+    if (printMatrix) {
+        // Вывод максимальных элементов в столбцах (последовательная версия)
+        cout << "Max elements in columns (sequential):" << endl;
+        for (int i = 0; i < n; ++i) {
+            cout << maxElementsSequential[i] << " ";
+        }
+        cout << endl;
+
+        // Вывод максимальных элементов в столбцах (параллельная версия)
+        cout << "Max elements in columns (parallel):" << endl;
+        for (int i = 0; i < n; ++i) {
+            cout << maxElementsParallel[i] << " ";
+        }
+        cout << endl;
+
+        cout << "Column statistics (min / max @ argmax / sum / top-" << stats.k << "):" << endl;
+        for (int j = 0; j < n; ++j) {
+            cout << "Column " << j << ": " << stats.min[j] << " / " << stats.max[j] << " @ " << stats.argmax[j]
+                 << " / " << stats.sum[j] << " /";
+            for (size_t r = 0; r < stats.k; ++r) cout << " " << stats.top[j * stats.k + r];
+            cout << endl;
+        }
     }
-    cout << endl;
 
     // Проверка корректности результатов
     bool correct = true;
     for (int i = 0; i < n; ++i) {
-        if (maxElementsSequential[i] != maxElementsParallel[i]) {
+        if (maxElementsSequential[i] != maxElementsParallel[i] ||
+            maxElementsSequential[i] != maxElementsSimd[i] ||
+            maxElementsSequential[i] != stats.max[i] || matrix[stats.argmax[i]][i] != stats.max[i]) {
             correct = false;
             break;
         }
     }
 
+    // All с k по умолчанию (0) — без top-k; проверяется на маленькой матрице с известным ответом
+    const int tiny[3][4] = {{3, -1, 7, 0}, {5, -2, 6, -4}, {1, -3, 2, 9}};
+    Matrix<int> tinyMatrix(3, 4);
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 4; ++j) tinyMatrix(i, j) = tiny[i][j];
+    }
+    ColumnStatistics<int> tinyStats = computeColumnStatistics<column_stats::All>(MatrixView<int>(tinyMatrix));
+    const int tinyMin[4] = {1, -3, 2, -4}, tinyMax[4] = {5, -1, 7, 9}, tinySum[4] = {9, -6, 15, 5};
+    const size_t tinyArgmax[4] = {1, 0, 0, 2};
+    correct = correct && tinyStats.k == 0 && tinyStats.top.empty();
+    for (int j = 0; correct && j < 4; ++j) {
+        correct = tinyStats.min[j] == tinyMin[j] && tinyStats.max[j] == tinyMax[j] &&
+                  tinyStats.argmax[j] == tinyArgmax[j] && tinyStats.sum[j] == tinySum[j];
+    }
+
     if (correct) {
         cout << "Results are consistent." << endl;
     }
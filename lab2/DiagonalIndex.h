@@ -0,0 +1,237 @@
+#pragma once
+
+#include <algorithm>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+#include <omp.h>
+
+#include "../common/Matrix.h"
+#include "DiagonalMaxEngine.h"
+
+// Индекс максимумов на диагоналях для матрицы, которая меняется точечно.
+//
+// Для каждой побочной (i + j = k) и главной (j - i = d - (m - 1)) диагонали хранится
+// дерево отрезков по максимуму. Лист дерева — не отдельный элемент, а блок из kLeafRows
+// строк диагонали (границы блоков кратны kLeafRows по абсолютному номеру строки),
+// так что деревья занимают около 2/kLeafRows от размера матрицы на направление,
+// а значения берутся из самой матрицы. Изменение ячейки пересчитывает один лист
+// (не больше kLeafRows элементов) и путь до корня: O(log n); максимум диагонали — корень, O(1).
+//
+// Построение параллельное: полосы по kLeafRows строк сворачиваются в локальный массив
+// диагоналей так же, как в findMaxOnDiagonalsBlocked (векторизуемый max по строке),
+// и каждая полоса пишет свой лист в деревья всех пересекающих её диагоналей.
+// Пакет изменений применяется параллельно по диагоналям: у каждой диагонали своё дерево.
+
+struct CellUpdate {
+    size_t row;
+    size_t col;
+    int value;
+};
+
+namespace diagonal_index {
+
+constexpr size_t kLeafRows = 16;
+
+// Деревья всех диагоналей одного направления в одном массиве:
+// дерево диагонали d занимает nodes[offset[d], offset[d + 1]), корень — элемент 1,
+// листья — элементы [P, 2P), где P — степень двойки
+struct Forest {
+    bool isMain = false;
+    size_t m = 0, n = 0;
+    std::vector<size_t> offset;
+    std::vector<int> nodes;
+
+    size_t count() const { return m + n - 1; }
+    size_t diagonal(size_t i, size_t j) const { return isMain ? j + (m - 1) - i : i + j; }
+    size_t firstRow(size_t d) const {
+        if (isMain) return d < m - 1 ? m - 1 - d : 0;
+        return d >= n ? d - (n - 1) : 0;
+    }
+    size_t lastRow(size_t d) const { return std::min(m - 1, isMain ? (n - 1) + (m - 1) - d : d); }
+    size_t column(size_t d, size_t i) const { return isMain ? i + d - (m - 1) : d - i; }
+    // Номер листа диагонали d, в который попадает строка i
+    size_t leaf(size_t d, size_t i) const { return i / kLeafRows - firstRow(d) / kLeafRows; }
+    size_t leafCount(size_t d) const { return (offset[d + 1] - offset[d]) / 2; }
+    int root(size_t d) const { return nodes[offset[d] + 1]; }
+    // Лист диагонали d для полосы строк с номером band
+    int& leafNode(size_t d, size_t band) { return nodes[offset[d] + leafCount(d) + band - firstRow(d) / kLeafRows]; }
+
+    void layout(size_t rows, size_t cols, bool main) {
+        isMain = main;
+        m = rows;
+        n = cols;
+        offset.assign(count() + 1, 0);
+        for (size_t d = 0; d < count(); ++d) {
+            size_t blocks = lastRow(d) / kLeafRows - firstRow(d) / kLeafRows + 1;
+            size_t leaves = 1;
+            while (leaves < blocks) leaves *= 2;
+            offset[d + 1] = offset[d] + 2 * leaves;
+        }
+    }
+
+    // Пересчёт листа q диагонали d по матрице и пути от него до корня
+    void refresh(const Matrix<int>& matrix, size_t d, size_t q) {
+        int* tree = nodes.data() + offset[d];
+        const size_t leaves = leafCount(d);
+        const size_t band = firstRow(d) / kLeafRows + q;
+        const size_t rowBegin = std::max(firstRow(d), band * kLeafRows);
+        const size_t rowEnd = std::min(lastRow(d) + 1, (band + 1) * kLeafRows);
+        int best = INT_MIN;
+        for (size_t i = rowBegin; i < rowEnd; ++i) best = std::max(best, matrix(i, column(d, i)));
+
+        size_t pos = leaves + q;
+        tree[pos] = best;
+        for (pos /= 2; pos >= 1; pos /= 2) tree[pos] = std::max(tree[2 * pos], tree[2 * pos + 1]);
+    }
+
+    // Внутренние узлы дерева диагонали d по готовым листьям
+    void buildInner(size_t d) {
+        int* tree = nodes.data() + offset[d];
+        for (size_t pos = leafCount(d) - 1; pos >= 1; --pos) tree[pos] = std::max(tree[2 * pos], tree[2 * pos + 1]);
+    }
+};
+
+} // namespace diagonal_index
+
+class DiagonalMaxIndex {
+public:
+    // Индекс по матрице; дальнейшие изменения матрицы должны идти через update/apply
+    explicit DiagonalMaxIndex(Matrix<int>& matrix, bool withMain = true) : matrix_(matrix), withMain_(withMain) {
+        if (matrix.rows() == 0 || matrix.cols() == 0) return;
+        anti_.layout(matrix.rows(), matrix.cols(), false);
+        if (withMain_) main_.layout(matrix.rows(), matrix.cols(), true);
+        build();
+    }
+
+    size_t count() const { return anti_.count(); }
+    int antiMax(size_t k) const { return anti_.root(k); }
+    int mainMax(size_t d) const { return main_.root(d); }
+
+    // Все максимумы в том же виде, что у findMaxOnDiagonalsBlocked
+    DiagonalMaxima maxima() const {
+        DiagonalMaxima result;
+        if (matrix_.rows() == 0 || matrix_.cols() == 0) return result;
+        result.anti.resize(count());
+        if (withMain_) result.main.resize(count());
+        for (size_t d = 0; d < count(); ++d) {
+            result.anti[d] = anti_.root(d);
+            if (withMain_) result.main[d] = main_.root(d);
+        }
+        return result;
+    }
+
+    // Число узлов всех деревьев
+    size_t nodeCount() const { return anti_.nodes.size() + main_.nodes.size(); }
+
+    void update(size_t i, size_t j, int value) {
+        check(i, j);
+        matrix_(i, j) = value;
+        refreshCell(anti_, i, j);
+        if (withMain_) refreshCell(main_, i, j);
+    }
+
+    // Пакет изменений: ячейки записываются в порядке пакета (при повторах побеждает последнее),
+    // затем затронутые листья пересчитываются параллельно по диагоналям
+    void apply(const std::vector<CellUpdate>& updates) {
+        for (const CellUpdate& u : updates) check(u.row, u.col);
+        for (const CellUpdate& u : updates) matrix_(u.row, u.col) = u.value;
+
+        // Ключ (номер дерева, лист): деревья главных диагоналей нумеруются после побочных
+        std::vector<uint64_t> keys;
+        keys.reserve(updates.size() * (withMain_ ? 2 : 1));
+        for (const CellUpdate& u : updates) {
+            size_t k = anti_.diagonal(u.row, u.col);
+            keys.push_back((uint64_t)k << 32 | anti_.leaf(k, u.row));
+            if (withMain_) {
+                size_t d = main_.diagonal(u.row, u.col);
+                keys.push_back((uint64_t)(count() + d) << 32 | main_.leaf(d, u.row));
+            }
+        }
+        std::sort(keys.begin(), keys.end());
+        keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+        // Границы групп ключей одного дерева
+        std::vector<size_t> groups;
+        for (size_t q = 0; q < keys.size(); ++q) {
+            if (q == 0 || keys[q] >> 32 != keys[q - 1] >> 32) groups.push_back(q);
+        }
+        groups.push_back(keys.size());
+
+        const long long groupCount = (long long)groups.size() - 1;
+#pragma omp parallel for schedule(dynamic, 16) if (groupCount > 64)
+        for (long long g = 0; g < groupCount; ++g) {
+            for (size_t q = groups[g]; q < groups[g + 1]; ++q) {
+                size_t tree = keys[q] >> 32;
+                size_t leaf = keys[q] & 0xFFFFFFFFu;
+                if (tree < count()) anti_.refresh(matrix_, tree, leaf);
+                else main_.refresh(matrix_, tree - count(), leaf);
+            }
+        }
+    }
+
+private:
+    void check(size_t i, size_t j) const {
+        if (i >= matrix_.rows() || j >= matrix_.cols()) throw std::runtime_error("Cell update out of range");
+    }
+
+    void refreshCell(diagonal_index::Forest& forest, size_t i, size_t j) {
+        size_t d = forest.diagonal(i, j);
+        forest.refresh(matrix_, d, forest.leaf(d, i));
+    }
+
+    void build() {
+        using diagonal_index::kLeafRows;
+        const size_t m = matrix_.rows();
+        const size_t n = matrix_.cols();
+        const long long bands = (m + kLeafRows - 1) / kLeafRows;
+        const long long diagonals = count();
+        anti_.nodes.resize(anti_.offset.back());
+        if (withMain_) main_.nodes.resize(main_.offset.back());
+
+#pragma omp parallel
+        {
+            // Заполнение INT_MIN теми же нитями, что дальше пишут листья
+#pragma omp for schedule(static)
+            for (long long d = 0; d < diagonals; ++d) {
+                std::fill(anti_.nodes.begin() + anti_.offset[d], anti_.nodes.begin() + anti_.offset[d + 1], INT_MIN);
+                if (withMain_) {
+                    std::fill(main_.nodes.begin() + main_.offset[d], main_.nodes.begin() + main_.offset[d + 1], INT_MIN);
+                }
+            }
+
+            // Полоса строк [r0, r0 + kLeafRows): локальные диагонали anti[t] ~ k = r0 + t,
+            // main[t] ~ d = t + (m - 1) - (r0 + kLeafRows - 1)
+            std::vector<int> anti(n + kLeafRows - 1), mainDiag(n + kLeafRows - 1);
+#pragma omp for schedule(static)
+            for (long long q = 0; q < bands; ++q) {
+                const size_t r0 = q * kLeafRows;
+                const size_t rows = std::min(kLeafRows, m - r0);
+                std::fill(anti.begin(), anti.end(), INT_MIN);
+                std::fill(mainDiag.begin(), mainDiag.end(), INT_MIN);
+                diagonal_max::foldRows(MatrixView<int>(matrix_).rowRange(r0, r0 + rows), 0, rows, anti.data(),
+                                       mainDiag.data() + (kLeafRows - rows), withMain_);
+
+                for (size_t t = 0; t < n + rows - 1; ++t) anti_.leafNode(r0 + t, q) = anti[t];
+                if (withMain_) {
+                    for (size_t t = kLeafRows - rows; t < n + kLeafRows - 1; ++t) {
+                        main_.leafNode(t + (m - 1) - (r0 + kLeafRows - 1), q) = mainDiag[t];
+                    }
+                }
+            }
+
+#pragma omp for schedule(dynamic, 64)
+            for (long long d = 0; d < diagonals; ++d) {
+                anti_.buildInner(d);
+                if (withMain_) main_.buildInner(d);
+            }
+        }
+    }
+
+    Matrix<int>& matrix_;
+    bool withMain_;
+    diagonal_index::Forest anti_;
+    diagonal_index::Forest main_;
+};
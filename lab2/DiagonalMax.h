@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+#include <omp.h>
+
+#include "../common/Trace.h"
+
+// Исходные ядра поиска максимумов на побочных диагоналях квадратной матрицы
+
+// Функция для поиска максимального элемента на заданной диагонали
+inline int findMaxInDiagonal(const std::vector<std::vector<int>>& matrix, int diagonalIndex) {
+    int maxElement = INT16_MIN; // Инициализируем минимальным возможным значением
+    int n = matrix.size();
+    for (int i = 0; i < n; ++i) {
+        int j = diagonalIndex - i;
+        if (j >= 0 && j < n) {
+            if (matrix[i][j] > maxElement) {
+                maxElement = matrix[i][j];
+            }
+        }
+    }
+    return maxElement;
+}
+
+// Параллельная версия Program2: нить t берёт диагонали t, t + p, t + 2p, ... в локальный массив,
+// локальные массивы сливаются в общий в critical. printThreads — печать номера каждой нити
+inline std::vector<int> findMaxOnDiagonalsParallel(const std::vector<std::vector<int>>& matrix,
+                                                   bool printThreads = false) {
+    int n = matrix.size();
+    std::vector<int> maxElements(2 * n - 1, INT16_MIN);
+#pragma omp parallel
+    {
+        int numThreads = omp_get_num_threads();
+        int threadId = omp_get_thread_num();
+        if (printThreads) printf("threads=%d num=%d\n", numThreads, threadId);
+        // Локальный массив для хранения максимальных значений каждой нити
+        std::vector<int> localMax(2 * n - 1, INT16_MIN);
+
+        // Каждая нить обрабатывает свои диагонали
+        {
+            TraceScope work("localMax");
+            for (int i = threadId; i < 2 * n - 1; i += numThreads) {
+                localMax[i] = findMaxInDiagonal(matrix, i);
+            }
+        }
+
+        // Объединение результатов из локального массива в общий массив
+        // (маркеры ожидания и удержания critical — для трассировки без OMPT)
+        trace::begin("critical wait", "sync", trace::Marker::Construct);
+#pragma omp critical
+        {
+            trace::end("critical wait", trace::Marker::Construct);
+            TraceScope hold("critical", "sync", trace::Marker::Construct);
+            for (int i = 0; i < 2 * n - 1; ++i) {
+                if (localMax[i] > maxElements[i]) {
+                    maxElements[i] = localMax[i];
+                }
+            }
+        }
+    }
+    return maxElements;
+}
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <algorithm>
+#include <climits>
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include <omp.h>
+
+#include "../common/Matrix.h"
+#include "../common/MatrixFile.h"
+
+// Поиск максимумов на всех диагоналях матрицы m×n за один проход.
+//
+// Побочные диагонали нумеруются k = i + j, главные (направление i - j) — d = j - i + (m - 1),
+// и тех и других m + n - 1. Нити получают непрерывные блоки строк, блок обходится
+// плитками kTileRows×kTileCols: для строки i отрезок diag[i + j0 .. i + j1) смежный
+// в памяти, поэтому внутренний цикл по j — обычный векторизуемый max без ветвлений,
+// а окно диагоналей плитки помещается в L1. Локальные массивы нитей сливаются
+// деревом за log2(p) шагов вместо критической секции.
+
+struct DiagonalMaxima {
+    std::vector<int> anti; // максимумы на диагоналях i + j = k
+    std::vector<int> main; // максимумы на диагоналях j - i = d - (m - 1)
+};
+
+namespace diagonal_max {
+
+constexpr size_t kTileRows = 64;
+constexpr size_t kTileCols = 1024;
+
+// Свёртка строк [rowBegin, rowEnd) в локальные массивы диагоналей
+inline void foldRows(const MatrixView<int>& matrix, size_t rowBegin, size_t rowEnd,
+                     int* anti, int* mainDiag, bool withMain) {
+    const size_t m = matrix.rows();
+    const size_t n = matrix.cols();
+    for (size_t tileRow = rowBegin; tileRow < rowEnd; tileRow += kTileRows) {
+        const size_t tileRowEnd = std::min(tileRow + kTileRows, rowEnd);
+        for (size_t tileCol = 0; tileCol < n; tileCol += kTileCols) {
+            const size_t width = std::min(kTileCols, n - tileCol);
+            for (size_t i = tileRow; i < tileRowEnd; ++i) {
+                const int* __restrict row = matrix.row(i) + tileCol;
+                int* __restrict a = anti + i + tileCol;
+#pragma omp simd
+                for (size_t j = 0; j < width; ++j) a[j] = std::max(a[j], row[j]);
+                if (withMain) {
+                    int* __restrict d = mainDiag + (m - 1 - i) + tileCol;
+#pragma omp simd
+                    for (size_t j = 0; j < width; ++j) d[j] = std::max(d[j], row[j]);
+                }
+            }
+        }
+    }
+}
+
+inline void mergeInto(int* __restrict dst, const int* __restrict src, size_t count) {
+#pragma omp simd
+    for (size_t k = 0; k < count; ++k) dst[k] = std::max(dst[k], src[k]);
+}
+
+// Свёртка матрицы всей командой нитей; вызывается каждой нитью внутри parallel-области.
+// partial — общий буфер на perThread элементов для каждой нити команды ([anti | main]).
+// После возврата (завершается барьером) результат лежит в первых perThread элементах.
+inline void foldTeam(const MatrixView<int>& matrix, int* partial, size_t perThread, bool withMain) {
+    const size_t m = matrix.rows();
+    const size_t count = m + matrix.cols() - 1;
+    const int numThreads = omp_get_num_threads();
+    const int threadId = omp_get_thread_num();
+
+    int* local = partial + static_cast<size_t>(threadId) * perThread;
+    std::fill(local, local + perThread, INT_MIN);
+
+    const size_t rowBegin = m * threadId / numThreads;
+    const size_t rowEnd = m * (threadId + 1) / numThreads;
+    foldRows(matrix, rowBegin, rowEnd, local, local + count, withMain);
+
+    // Древовидная редукция: на шаге step нить t забирает результат нити t + step
+    for (int step = 1; step < numThreads; step *= 2) {
+#pragma omp barrier
+        if (threadId % (2 * step) == 0 && threadId + step < numThreads) {
+            const int* other = partial + static_cast<size_t>(threadId + step) * perThread;
+            mergeInto(local, other, perThread);
+        }
+    }
+#pragma omp barrier
+}
+
+} // namespace diagonal_max
+
+// Максимумы на побочных (и, если withMain, главных) диагоналях за один проход по матрице
+inline DiagonalMaxima findMaxOnDiagonalsBlocked(const MatrixView<int>& matrix, bool withMain = true) {
+    const size_t m = matrix.rows();
+    const size_t n = matrix.cols();
+    DiagonalMaxima result;
+    if (m == 0 || n == 0) return result;
+
+    const size_t count = m + n - 1;
+    const int maxThreads = omp_get_max_threads();
+    // Локальные массивы нитей: [anti | main] для каждой нити
+    const size_t perThread = withMain ? 2 * count : count;
+    std::unique_ptr<int[]> partial(new int[static_cast<size_t>(maxThreads) * perThread]);
+
+#pragma omp parallel
+    diagonal_max::foldTeam(matrix, partial.get(), perThread, withMain);
+
+    result.anti.assign(partial.get(), partial.get() + count);
+    if (withMain) result.main.assign(partial.get() + count, partial.get() + 2 * count);
+    return result;
+}
+
+// Максимумы на диагоналях матрицы из отображённого в память файла, порциями по chunkBytes байт.
+// Номера диагоналей порции пересчитываются в глобальные: побочная k сдвигается на rowBegin,
+// главная — на (m - 1) - (rowBegin + chunkRows - 1).
+inline DiagonalMaxima findMaxOnDiagonalsMapped(const MappedMatrixFile& file, bool withMain = true,
+                                               size_t chunkBytes = 64u << 20) {
+    const size_t m = file.rows();
+    const size_t n = file.cols();
+    DiagonalMaxima result;
+    if (m == 0 || n == 0) return result;
+    result.anti.assign(m + n - 1, INT_MIN);
+    if (withMain) result.main.assign(m + n - 1, INT_MIN);
+
+    forEachRowChunk<int>(file, chunkBytes, [&](const MatrixView<int>& chunk, size_t rowBegin) {
+        DiagonalMaxima local = findMaxOnDiagonalsBlocked(chunk, withMain);
+        diagonal_max::mergeInto(result.anti.data() + rowBegin, local.anti.data(), local.anti.size());
+        if (withMain) {
+            size_t shift = (m - 1) - (rowBegin + chunk.rows() - 1);
+            diagonal_max::mergeInto(result.main.data() + shift, local.main.data(), local.main.size());
+        }
+    });
+    return result;
+}
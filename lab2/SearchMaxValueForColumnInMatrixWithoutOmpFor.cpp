@@ -3,98 +3,324 @@
 #include <algorithm>
 #include <chrono>
 #include <omp.h>
+#include <climits>
+#include <cstdlib>
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#include "../common/BatchRunner.h"
+#include "../common/CounterRng.h"
+#include "../common/MatrixGenerator.h"
+#include "../common/PerfCounters.h"
+#include "DiagonalIndex.h"
+#include "DiagonalMax.h"
+#include "DiagonalMaxEngine.h"
 
 using namespace std;
 
-// Функция для поиска максимального элемента на заданной диагонали
-int findMaxInDiagonal(const vector<vector<int>>& matrix, int diagonalIndex) {
-    int maxElement = INT16_MIN; // Инициализируем минимальным возможным значением
+// Исходные последовательная и параллельная версии (квадратная матрица n×n)
+void runSquareDiagonals(const vector<vector<int>>& matrix, bool verbose) {
     int n = matrix.size();
-    for (int i = 0; i < n; ++i) {
-        int j = diagonalIndex - i;
-        if (j >= 0 && j < n) {
-            if (matrix[i][j] > maxElement) {
-                maxElement = matrix[i][j];
-            }
-        }
-    }
-    return maxElement;
-}
-
-int main() {
-    int n;
-    cout << "Enter matrix volume: ";
-    cin >> n;
 
-    // Инициализация матрицы случайными значениями
-    vector<vector<int>> matrix(n, vector<int>(n));
-    for (int i = 0; i < n; ++i) {
-        for (int j = 0; j < n; ++j) {
-            matrix[i][j] = rand() % 100; // Заполняем случайными числами от 0 до 99
-        }
-    }
-
-    // Вывод матрицы
-    cout << "Matrix:\n";
-    for (const auto& row : matrix) {
-        for (int value : row) {
-            cout << value << " ";
-        }
-        cout << endl;
-    }
+    // Элементы, просмотренные findMaxInDiagonal: каждая из 2n - 1 диагоналей проходит n строк
+    const double visited = (2.0 * n - 1) * n;
 
     // Замер времени выполнения без распараллеливания
+    PerfRegion perfSequential("consecutive");
     auto start = chrono::high_resolution_clock::now();
     vector<int> maxElementsSequential(2 * n - 1);
     for (int i = 0; i < 2 * n - 1; ++i) {
         maxElementsSequential[i] = findMaxInDiagonal(matrix, i);
     }
     auto end = chrono::high_resolution_clock::now();
+    perfSequential.stop();
     auto duration = chrono::duration_cast<chrono::nanoseconds>(end - start);
 
-    cout << "Max elements on diagonals (consecutive):\n";
-    for (int i = 0; i < 2 * n - 1; ++i) {
-        cout << "Diagonal " << i << ": " << maxElementsSequential[i] << endl;
+    if (verbose) {
+        cout << "Max elements on diagonals (consecutive):\n";
+        for (int i = 0; i < 2 * n - 1; ++i) {
+            cout << "Diagonal " << i << ": " << maxElementsSequential[i] << endl;
+        }
     }
     cout << "Ex. time (consecutive): " << duration.count() << " nanoseconds\n";
+    perfSequential.print(cout, visited);
 
     // Замер времени выполнения с распараллеливанием
+    // (число нитей задаётся до открытия счётчиков, чтобы они попали на все нити команды;
+    // 6 нитей — только для этого ядра, дальше восстанавливается прежнее значение)
+    int savedThreads = omp_get_max_threads();
+    omp_set_num_threads(6);
+    PerfRegion perfParallel("parallel");
     start = chrono::high_resolution_clock::now();
 
-    vector<int> maxElementsParallel(2 * n - 1, INT16_MIN); // Инициализация значениями INT_MIN
-    omp_set_num_threads(6);
-#pragma omp parallel
-    {
-        int numThreads = omp_get_num_threads();
-        int threadId = omp_get_thread_num();
-        printf("threads=%d num=%d\n", numThreads, threadId);
-        // Локальный массив для хранения максимальных значений каждой нити
-        vector<int> localMax(2 * n - 1, INT16_MIN);
-
-        // Каждая нить обрабатывает свои диагонали
-        for (int i = threadId; i < 2 * n - 1; i += numThreads) {
-            localMax[i] = findMaxInDiagonal(matrix, i);
+    vector<int> maxElementsParallel = findMaxOnDiagonalsParallel(matrix, true);
+
+    end = chrono::high_resolution_clock::now();
+    perfParallel.stop();
+    omp_set_num_threads(savedThreads);
+    duration = chrono::duration_cast<chrono::nanoseconds>(end - start);
+
+    if (verbose) {
+        cout << "Max elements on diagonals (parallel):\n";
+        for (int i = 0; i < 2 * n - 1; ++i) {
+            cout << "Diagonal " << i << ": " << maxElementsParallel[i] << endl;
+        }
+    }
+    cout << "Ex. time (parallel): " << duration.count() << " nanoseconds\n";
+    perfParallel.print(cout, visited);
+}
+
+// Контрольный подсчёт максимумов на диагоналях прямоугольной матрицы прямым перебором
+DiagonalMaxima findMaxOnDiagonalsReference(const Matrix<int>& matrix) {
+    int m = matrix.rows();
+    int n = matrix.cols();
+    DiagonalMaxima result;
+    result.anti.assign(m + n - 1, INT_MIN);
+    result.main.assign(m + n - 1, INT_MIN);
+    for (int i = 0; i < m; ++i) {
+        for (int j = 0; j < n; ++j) {
+            result.anti[i + j] = max(result.anti[i + j], matrix(i, j));
+            result.main[j - i + m - 1] = max(result.main[j - i + m - 1], matrix(i, j));
         }
+    }
+    return result;
+}
+
+// Поиск по матрице из двоичного файла (см. common/MatrixFile.h) без загрузки в память целиком
+int runFileMode(const char* path) {
+    try {
+        MappedMatrixFile file(path);
+        // Индексы диагоналей ниже — int: m + n - 1 должно помещаться в int
+        if (file.rows() > (size_t)INT_MAX || file.cols() > (size_t)INT_MAX - file.rows()) {
+            throw runtime_error("Matrix is too large: rows + cols must not exceed INT_MAX");
+        }
+        int m = file.rows();
+        int n = file.cols();
 
-        // Объединение результатов из локального массива в общий массив
-#pragma omp critical
-        {
-            for (int i = 0; i < 2 * n - 1; ++i) {
-                if (localMax[i] > maxElementsParallel[i]) {
-                    maxElementsParallel[i] = localMax[i];
-                }
+        auto start = chrono::high_resolution_clock::now();
+        DiagonalMaxima result = findMaxOnDiagonalsMapped(file);
+        auto end = chrono::high_resolution_clock::now();
+        auto duration = chrono::duration_cast<chrono::nanoseconds>(end - start);
+
+        cout << "Matrix file: " << path << " (" << m << " x " << n << ")\n";
+        if (m <= 20 && n <= 20) {
+            cout << "Max elements on diagonals (file, i+j / j-i):\n";
+            for (int k = 0; k < m + n - 1; ++k) {
+                cout << "Diagonal " << k << ": " << result.anti[k] << " / " << result.main[k] << endl;
             }
         }
+        cout << "Ex. time (mapped streaming): " << duration.count() << " nanoseconds\n";
+    }
+    catch (const exception& e) {
+        cerr << e.what() << endl;
+        return -1;
     }
+    return 0;
+}
+
+// Задание пакетного режима: матрица m×n из generateRow с ключом seed.
+// Матрица и локальные массивы нитей переиспользуются между заданиями.
+struct DiagonalJob {
+    long long m = 0, n = 0, seed = 0;
+    Matrix<int> matrix;
+    vector<int> partial;
+};
 
+// Пакетный режим: по строке "m n [seed]" на задание из файла или stdin,
+// результат каждого задания — строка "номер m n время_мкс | побочные | главные"
+int runBatchMode(istream& in) {
+    DiagonalJob job;
+    size_t count = runBatch(in, cout, job,
+        [](const string& line, DiagonalJob& job) {
+            istringstream fields(line);
+            job.seed = 0;
+            if (!(fields >> job.m >> job.n) || job.m <= 0 || job.n <= 0) {
+                throw runtime_error("expected positive \"m n [seed]\"");
+            }
+            fields >> job.seed;
+            job.matrix.reshape(job.m, job.n);
+            size_t needed = (size_t)omp_get_num_threads() * 2 * (job.m + job.n - 1);
+            if (job.partial.size() < needed) job.partial.resize(needed);
+        },
+        [](DiagonalJob& job) {
+            // Разбиение строк то же, что в foldTeam: каждая нить заполняет строки, которые будет читать
+            const int numThreads = omp_get_num_threads();
+            const int threadId = omp_get_thread_num();
+            for (long long i = job.m * threadId / numThreads; i < job.m * (threadId + 1) / numThreads; ++i) {
+                generateRow(job.matrix, 0, i, 1000, job.seed);
+            }
+#pragma omp barrier
+            diagonal_max::foldTeam(job.matrix, job.partial.data(), 2 * (job.m + job.n - 1), true);
+        },
+        [](size_t index, const DiagonalJob& job, double seconds, ostream& out) {
+            const long long count = job.m + job.n - 1;
+            out << index << ' ' << job.m << ' ' << job.n << ' ' << seconds * 1e6 << " |";
+            for (long long k = 0; k < count; ++k) out << ' ' << job.partial[k];
+            out << " |";
+            for (long long k = 0; k < count; ++k) out << ' ' << job.partial[count + k];
+            out << '\n';
+        });
+    cerr << "Jobs completed: " << count << endl;
+    return 0;
+}
+
+// Режим индекса: матрица m×n меняется пакетами по batchSize случайных ячеек, после каждого пакета
+// максимумы диагоналей берутся из DiagonalMaxIndex; для сравнения — полный пересчёт findMaxOnDiagonalsBlocked
+int runUpdateMode(long long m, long long n, long long batches, long long batchSize, uint64_t seed) {
+    if (m <= 0 || n <= 0 || batches <= 0 || batchSize <= 0) {
+        cerr << "Usage: Program2 --updates m n batches batch_size [seed]\n";
+        return -1;
+    }
+    Matrix<int> dense(m, n);
+    generateRowBlock(dense, 0, 100, seed);
+
+    auto start = chrono::high_resolution_clock::now();
+    DiagonalMaxIndex index(dense);
+    auto end = chrono::high_resolution_clock::now();
+    double buildTime = chrono::duration<double>(end - start).count();
+
+    start = chrono::high_resolution_clock::now();
+    DiagonalMaxima full = findMaxOnDiagonalsBlocked(dense);
     end = chrono::high_resolution_clock::now();
+    double fullTime = chrono::duration<double>(end - start).count();
+
+    // Изменения — из отдельного потока счётчикового генератора: ячейка и новое значение из [0, 1000)
+    const uint64_t key = counter_rng::streamKey(seed, 1ULL << 40);
+    vector<CellUpdate> batch(batchSize);
+    double applyTime = 0.0;
+    long long checksum = 0;
+    for (long long b = 0; b < batches; ++b) {
+        for (long long u = 0; u < batchSize; ++u) {
+            uint64_t counter = 3 * (b * batchSize + u);
+            batch[u] = {counter_rng::bounded(counter_rng::at(key, counter), m),
+                        counter_rng::bounded(counter_rng::at(key, counter + 1), n),
+                        (int)counter_rng::bounded(counter_rng::at(key, counter + 2), 1000)};
+        }
+        start = chrono::high_resolution_clock::now();
+        index.apply(batch);
+        // Запрос после пакета: максимумы диагоналей, проходящих через первую изменённую ячейку
+        checksum += index.antiMax(batch[0].row + batch[0].col) + index.mainMax(batch[0].col + (m - 1) - batch[0].row);
+        end = chrono::high_resolution_clock::now();
+        applyTime += chrono::duration<double>(end - start).count();
+    }
+
+    DiagonalMaxima indexed = index.maxima();
+    full = findMaxOnDiagonalsBlocked(dense);
+    cout << "Matrix " << m << " x " << n << ", index nodes: " << index.nodeCount() << endl;
+    cout << "Index build: " << buildTime * 1e3 << " ms, full recompute: " << fullTime * 1e3 << " ms\n";
+    cout << "Updates: " << batches << " batches x " << batchSize << ", " << applyTime / batches * 1e6
+         << " us per batch, " << applyTime / (batches * batchSize) * 1e9 << " ns per update (checksum " << checksum
+         << ")\n";
+    cout << "Speedup per batch vs full recompute: " << fullTime / (applyTime / batches) << "x\n";
+    if (indexed.anti == full.anti && indexed.main == full.main) {
+        cout << "Results are consistent.\n";
+    }
+    else {
+        cout << "Results are inconsistent.\n";
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    // Точечные изменения: Program2 --updates m n batches batch_size [seed]
+    if (argc >= 6 && string(argv[1]) == "--updates") {
+        return runUpdateMode(atoll(argv[2]), atoll(argv[3]), atoll(argv[4]), atoll(argv[5]),
+                             argc >= 7 ? strtoull(argv[6], nullptr, 10) : 0);
+    }
+    // Пакетный режим: Program2 --batch [jobs.txt] (без файла задания читаются из stdin)
+    if (argc >= 2 && string(argv[1]) == "--batch") {
+        if (argc >= 3) {
+            ifstream jobs(argv[2]);
+            if (!jobs) {
+                cerr << "Cannot open file: " << argv[2] << endl;
+                return -1;
+            }
+            return runBatchMode(jobs);
+        }
+        return runBatchMode(cin);
+    }
+
+    // Матрица из файла: Program2 --file path
+    if (argc >= 3 && string(argv[1]) == "--file") {
+        return runFileMode(argv[2]);
+    }
+
+    int m, n;
+    // Размеры можно передать аргументами (Program2 m n), тогда матрица может быть прямоугольной
+    if (argc >= 3) {
+        m = atoi(argv[1]);
+        n = atoi(argv[2]);
+    }
+    else {
+        cout << "Enter matrix volume: ";
+        cin >> n;
+        m = n;
+    }
+    if (m <= 0 || n <= 0) {
+        cerr << "Matrix size must be positive.\n";
+        return -1;
+    }
+    // Большие матрицы и списки диагоналей не выводим
+    bool verbose = m <= 20 && n <= 20;
+
+    // Инициализация матрицы случайными значениями от 0 до 99 (параллельно, см. common/MatrixGenerator.h)
+    vector<vector<int>> matrix = generateNestedMatrix(m, n, 100);
+
+    // Вывод матрицы
+    if (verbose) {
+        cout << "Matrix:\n";
+        for (const auto& row : matrix) {
+            for (int value : row) {
+                cout << value << " ";
+            }
+            cout << endl;
+        }
+    }
+
+    // Исходные версии рассчитаны только на квадратную матрицу
+    if (m == n) {
+        runSquareDiagonals(matrix, verbose);
+    }
+
+    // Однопроходный блочный поиск по непрерывной матрице (побочные и главные диагонали)
+    // Строки заполняют те же нити, что потом сворачивают их в findMaxOnDiagonalsBlocked
+    Matrix<int> dense(m, n);
+    generateRowBlock(dense, 0, 100);
+    const double elements = (double)m * n;
+    PerfRegion perfAnti("blocked, i+j only");
+    auto start = chrono::high_resolution_clock::now();
+    DiagonalMaxima antiOnly = findMaxOnDiagonalsBlocked(dense, false);
+    auto end = chrono::high_resolution_clock::now();
+    perfAnti.stop();
+    auto duration = chrono::duration_cast<chrono::nanoseconds>(end - start);
+    cout << "Ex. time (blocked, i+j only): " << duration.count() << " nanoseconds\n";
+    perfAnti.print(cout, elements);
+
+    PerfRegion perfBoth("blocked, both directions");
+    start = chrono::high_resolution_clock::now();
+    DiagonalMaxima blocked = findMaxOnDiagonalsBlocked(dense);
+    end = chrono::high_resolution_clock::now();
+    perfBoth.stop();
     duration = chrono::duration_cast<chrono::nanoseconds>(end - start);
 
-    cout << "Max elements on diagonals (parallel):\n";
-    for (int i = 0; i < 2 * n - 1; ++i) {
-        cout << "Diagonal " << i << ": " << maxElementsParallel[i] << endl;
+    if (verbose) {
+        cout << "Max elements on diagonals (blocked, i+j / j-i):\n";
+        for (int k = 0; k < m + n - 1; ++k) {
+            cout << "Diagonal " << k << ": " << blocked.anti[k] << " / " << blocked.main[k] << endl;
+        }
+    }
+    cout << "Ex. time (blocked, both directions): " << duration.count() << " nanoseconds\n";
+    perfBoth.print(cout, elements);
+
+    DiagonalMaxima reference = findMaxOnDiagonalsReference(dense);
+    if (blocked.anti == reference.anti && blocked.main == reference.main && antiOnly.anti == reference.anti) {
+        cout << "Results are consistent.\n";
+    }
+    else {
+        cout << "Results are inconsistent.\n";
     }
-    cout << "Ex. time (parallel): " << duration.count() << " nanoseconds\n";
 
     return 0;
 }
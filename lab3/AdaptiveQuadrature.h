@@ -0,0 +1,172 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <omp.h>
+
+// Адаптивное интегрирование: адаптивный метод Симпсона и Гаусса–Кронрода G7K15.
+//
+// Отрезок делится пополам только там, где оценка погрешности больше допуска,
+// доставшегося этому подотрезку. Дерево деления обходится задачами OpenMP:
+// до глубины taskDepth каждая половина порождает отдельную задачу, глубже
+// рекурсия идёт внутри задачи, чтобы не плодить мелкие задачи.
+// Допуск задаётся абсолютным и относительным: tol = max(absTol, relTol * |I|),
+// где I — грубая оценка интеграла по всему отрезку.
+
+struct QuadratureResult {
+    double value = 0.0;
+    double errorEstimate = 0.0; // оценка абсолютной погрешности
+    long long evaluations = 0;  // число вычислений функции
+    int depth = 0;              // максимальная достигнутая глубина деления
+};
+
+inline void accumulate(QuadratureResult& total, const QuadratureResult& part) {
+    total.value += part.value;
+    total.errorEstimate += part.errorEstimate;
+    total.evaluations += part.evaluations;
+    total.depth = std::max(total.depth, part.depth);
+}
+
+struct AdaptiveOptions {
+    double absTol = 1e-10;
+    double relTol = 1e-10;
+    int maxDepth = 50;  // глубже отрезок не делится, даже если точность не достигнута
+    int taskDepth = 10; // до этой глубины половины обрабатываются отдельными задачами
+};
+
+namespace adaptive_detail {
+
+// Шаг адаптивного Симпсона на [a, b]; fa, fm, fb — значения в концах и середине,
+// whole — формула Симпсона на всём [a, b]
+template <typename F>
+QuadratureResult simpsonStep(double a, double b, double fa, double fm, double fb, double whole,
+                             double tol, int depth, const AdaptiveOptions& options) {
+    double m = 0.5 * (a + b);
+    double lm = 0.5 * (a + m), rm = 0.5 * (m + b);
+    double flm = F::eval(lm), frm = F::eval(rm);
+    double left = (m - a) / 6.0 * (fa + 4.0 * flm + fm);
+    double right = (b - m) / 6.0 * (fm + 4.0 * frm + fb);
+    double delta = left + right - whole;
+
+    QuadratureResult result;
+    result.evaluations = 2;
+    result.depth = depth;
+    if (depth >= options.maxDepth || std::fabs(delta) <= 15.0 * tol) {
+        // Поправка Ричардсона повышает порядок до пятого
+        result.value = left + right + delta / 15.0;
+        result.errorEstimate = std::fabs(delta) / 15.0;
+        return result;
+    }
+
+    QuadratureResult l, r;
+#pragma omp task shared(l) if(depth < options.taskDepth)
+    l = simpsonStep<F>(a, m, fa, flm, fm, left, 0.5 * tol, depth + 1, options);
+    r = simpsonStep<F>(m, b, fm, frm, fb, right, 0.5 * tol, depth + 1, options);
+#pragma omp taskwait
+    accumulate(result, l);
+    accumulate(result, r);
+    return result;
+}
+
+// Узлы Кронрода на [-1, 1] (неотрицательные), веса K15 и веса G7 для узлов с чётными номерами
+constexpr double kXgk[8] = {
+    0.991455371120812639206854697526329, 0.949107912342758524526189684047851,
+    0.864864423359769072789712788640926, 0.741531185599394439863864773280788,
+    0.586087235467691130294144845693013, 0.405845151377397166906606412076961,
+    0.207784955007898467600689403773245, 0.000000000000000000000000000000000};
+constexpr double kWgk[8] = {
+    0.022935322010529224963732008058970, 0.063092092629978553290700663189204,
+    0.104790010322250183839876322541518, 0.140653259715525918745189590510238,
+    0.169004726639267902826583426598550, 0.190350578064785409913256402421014,
+    0.204432940075298892414161999234649, 0.209482141084727828012999174891714};
+constexpr double kWg[4] = {
+    0.129484966168869693270611432679082, 0.279705391489276667901467771423780,
+    0.381830050505118944950369775488975, 0.417959183673469387755102040816327};
+
+// Правило G7K15 на [a, b]: значение K15 и |K15 - G7| как оценка погрешности
+template <typename F>
+void gaussKronrod15(double a, double b, double& value, double& error) {
+    double center = 0.5 * (a + b);
+    double half = 0.5 * (b - a);
+    double fc = F::eval(center);
+    double kronrod = fc * kWgk[7];
+    double gauss = fc * kWg[3];
+    for (int k = 0; k < 7; ++k) {
+        double dx = half * kXgk[k];
+        double pair = F::eval(center - dx) + F::eval(center + dx);
+        kronrod += kWgk[k] * pair;
+        if (k % 2 == 1) gauss += kWg[k / 2] * pair;
+    }
+    value = kronrod * half;
+    error = std::fabs((kronrod - gauss) * half);
+}
+
+template <typename F>
+QuadratureResult kronrodStep(double a, double b, double value, double error, double tol, int depth,
+                             const AdaptiveOptions& options) {
+    QuadratureResult result;
+    result.depth = depth;
+    if (depth >= options.maxDepth || error <= tol) {
+        result.value = value;
+        result.errorEstimate = error;
+        return result;
+    }
+
+    double m = 0.5 * (a + b);
+    double lv, le, rv, re;
+    gaussKronrod15<F>(a, m, lv, le);
+    gaussKronrod15<F>(m, b, rv, re);
+    result.evaluations = 30;
+
+    QuadratureResult l, r;
+#pragma omp task shared(l) if(depth < options.taskDepth)
+    l = kronrodStep<F>(a, m, lv, le, 0.5 * tol, depth + 1, options);
+    r = kronrodStep<F>(m, b, rv, re, 0.5 * tol, depth + 1, options);
+#pragma omp taskwait
+    accumulate(result, l);
+    accumulate(result, r);
+    return result;
+}
+
+// Запуск корня дерева задач: внутри параллельной области одной нитью
+template <typename Body>
+QuadratureResult runTaskTree(Body body) {
+    QuadratureResult result;
+    if (omp_in_parallel()) return body();
+#pragma omp parallel
+#pragma omp single
+    result = body();
+    return result;
+}
+
+} // namespace adaptive_detail
+
+// Адаптивный метод Симпсона
+template <typename F>
+QuadratureResult integrateAdaptiveSimpson(double a, double b, const AdaptiveOptions& options = {}) {
+    using namespace adaptive_detail;
+    double fa = F::eval(a), fm = F::eval(0.5 * (a + b)), fb = F::eval(b);
+    double whole = (b - a) / 6.0 * (fa + 4.0 * fm + fb);
+    double tol = std::max(options.absTol, options.relTol * std::fabs(whole));
+
+    QuadratureResult result = runTaskTree([&] {
+        return simpsonStep<F>(a, b, fa, fm, fb, whole, tol, 0, options);
+    });
+    result.evaluations += 3;
+    return result;
+}
+
+// Адаптивный метод Гаусса–Кронрода G7K15
+template <typename F>
+QuadratureResult integrateGaussKronrod(double a, double b, const AdaptiveOptions& options = {}) {
+    using namespace adaptive_detail;
+    double value, error;
+    gaussKronrod15<F>(a, b, value, error);
+    double tol = std::max(options.absTol, options.relTol * std::fabs(value));
+
+    QuadratureResult result = runTaskTree([&] {
+        return kronrodStep<F>(a, b, value, error, tol, 0, options);
+    });
+    result.evaluations += 15;
+    return result;
+}
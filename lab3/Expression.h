@@ -0,0 +1,487 @@
+#pragma once
+
+#include <cctype>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../common/DeterministicSum.h"
+#include "Integrands.h"
+
+// Подынтегральная функция, заданная строкой: выражение от x с операциями + - * / ^,
+// функциями sin, cos, exp, log, sqrt и константами (числа, pi, e).
+//
+// Строка разбирается один раз рекурсивным спуском в дерево, поддеревья из одних
+// констант сворачиваются в число, после чего дерево компилируется в байткод стековой
+// машины. Регистр стека — блок из kBlock значений, и каждая инструкция выполняется
+// SIMD-циклом сразу над всем блоком x: стоимость разбора инструкции делится на kBlock
+// точек, а sin/cos/exp/log/pow идут через векторные варианты libmvec. Операнды-константы
+// встраиваются в инструкцию (AddC, MulC, ...), целые степени до kMaxIntPower
+// раскрываются в умножения.
+
+namespace expression {
+
+constexpr size_t kBlock = 256;
+constexpr int kMaxIntPower = 16;
+
+enum class Op : uint8_t {
+    LoadX, LoadConst,
+    // над двумя верхними регистрами стека
+    Add, Sub, Mul, Div, Pow,
+    // над верхним регистром и константой инструкции (R — константа слева)
+    AddC, SubC, RSubC, MulC, DivC, RDivC, PowC, RPowC, PowInt,
+    // над верхним регистром
+    Neg, Sin, Cos, Exp, Log, Sqrt
+};
+
+struct Instruction {
+    Op op;
+    double value = 0.0; // константа LoadConst и операций с константой
+};
+
+// Узел дерева разбора: константа, x, унарная (left) или бинарная (left, right) операция
+struct Node {
+    Op op;
+    double value = 0.0;
+    std::unique_ptr<Node> left, right;
+
+    bool isConst() const { return op == Op::LoadConst; }
+};
+
+// Скалярное значение операции — для свёртки констант
+inline double apply(Op op, double l, double r = 0.0) {
+    switch (op) {
+    case Op::Add: return l + r;
+    case Op::Sub: return l - r;
+    case Op::Mul: return l * r;
+    case Op::Div: return l / r;
+    case Op::Pow: return std::pow(l, r);
+    case Op::Neg: return -l;
+    case Op::Sin: return std::sin(l);
+    case Op::Cos: return std::cos(l);
+    case Op::Exp: return std::exp(l);
+    case Op::Log: return std::log(l);
+    case Op::Sqrt: return std::sqrt(l);
+    default: return l;
+    }
+}
+
+inline std::unique_ptr<Node> makeConst(double value) {
+    auto node = std::make_unique<Node>();
+    node->op = Op::LoadConst;
+    node->value = value;
+    return node;
+}
+
+// Узел операции; если все операнды — константы, он сразу сворачивается в число
+inline std::unique_ptr<Node> makeOp(Op op, std::unique_ptr<Node> left, std::unique_ptr<Node> right = nullptr) {
+    if (left->isConst() && (!right || right->isConst())) {
+        return makeConst(apply(op, left->value, right ? right->value : 0.0));
+    }
+    auto node = std::make_unique<Node>();
+    node->op = op;
+    node->left = std::move(left);
+    node->right = std::move(right);
+    return node;
+}
+
+// Рекурсивный спуск:
+//   sum     := product (('+' | '-') product)*
+//   product := unary (('*' | '/') unary)*
+//   unary   := ('-' | '+') unary | power
+//   power   := primary ('^' unary)?         (правоассоциативно: 2^3^2 = 2^9, -x^2 = -(x^2))
+//   primary := число | x | pi | e | функция '(' sum ')' | '(' sum ')'
+class Parser {
+public:
+    explicit Parser(const std::string& text) : text_(text) {}
+
+    std::unique_ptr<Node> parse() {
+        auto node = parseSum();
+        skipSpaces();
+        if (pos_ < text_.size()) fail("лишний символ '" + std::string(1, text_[pos_]) + "'");
+        return node;
+    }
+
+private:
+    [[noreturn]] void fail(const std::string& message) const {
+        throw std::runtime_error("выражение, позиция " + std::to_string(pos_ + 1) + ": " + message);
+    }
+
+    void skipSpaces() {
+        while (pos_ < text_.size() && std::isspace((unsigned char)text_[pos_])) ++pos_;
+    }
+
+    bool accept(char c) {
+        skipSpaces();
+        if (pos_ < text_.size() && text_[pos_] == c) {
+            ++pos_;
+            return true;
+        }
+        return false;
+    }
+
+    void expect(char c) {
+        if (!accept(c)) fail(std::string("ожидается '") + c + "'");
+    }
+
+    std::unique_ptr<Node> parseSum() {
+        auto node = parseProduct();
+        while (true) {
+            if (accept('+')) node = makeOp(Op::Add, std::move(node), parseProduct());
+            else if (accept('-')) node = makeOp(Op::Sub, std::move(node), parseProduct());
+            else return node;
+        }
+    }
+
+    std::unique_ptr<Node> parseProduct() {
+        auto node = parseUnary();
+        while (true) {
+            if (accept('*')) node = makeOp(Op::Mul, std::move(node), parseUnary());
+            else if (accept('/')) node = makeOp(Op::Div, std::move(node), parseUnary());
+            else return node;
+        }
+    }
+
+    std::unique_ptr<Node> parseUnary() {
+        if (accept('-')) return makeOp(Op::Neg, parseUnary());
+        if (accept('+')) return parseUnary();
+        return parsePower();
+    }
+
+    std::unique_ptr<Node> parsePower() {
+        auto node = parsePrimary();
+        if (accept('^')) node = makeOp(Op::Pow, std::move(node), parseUnary());
+        return node;
+    }
+
+    std::unique_ptr<Node> parsePrimary() {
+        skipSpaces();
+        if (pos_ >= text_.size()) fail("неожиданный конец выражения");
+        if (accept('(')) {
+            auto node = parseSum();
+            expect(')');
+            return node;
+        }
+
+        const char c = text_[pos_];
+        if (std::isdigit((unsigned char)c) || c == '.') {
+            const char* begin = text_.c_str() + pos_;
+            char* end = nullptr;
+            double value = std::strtod(begin, &end);
+            if (end == begin) fail("неверное число");
+            pos_ += end - begin;
+            return makeConst(value);
+        }
+        if (!std::isalpha((unsigned char)c)) fail("неожиданный символ '" + std::string(1, c) + "'");
+
+        size_t start = pos_;
+        while (pos_ < text_.size() && std::isalnum((unsigned char)text_[pos_])) ++pos_;
+        const std::string name = text_.substr(start, pos_ - start);
+        if (name == "x") {
+            auto node = std::make_unique<Node>();
+            node->op = Op::LoadX;
+            return node;
+        }
+        if (name == "pi") return makeConst(M_PI);
+        if (name == "e") return makeConst(M_E);
+
+        Op op;
+        if (name == "sin") op = Op::Sin;
+        else if (name == "cos") op = Op::Cos;
+        else if (name == "exp") op = Op::Exp;
+        else if (name == "log") op = Op::Log;
+        else if (name == "sqrt") op = Op::Sqrt;
+        else {
+            pos_ = start;
+            fail("неизвестное имя " + name);
+        }
+        expect('(');
+        auto argument = parseSum();
+        expect(')');
+        return makeOp(op, std::move(argument));
+    }
+
+    const std::string& text_;
+    size_t pos_ = 0;
+};
+
+inline bool isCommutative(Op op) { return op == Op::Add || op == Op::Mul; }
+
+// Вариант операции с константой справа (constRight) или слева
+inline Op withConstant(Op op, bool constRight) {
+    switch (op) {
+    case Op::Add: return Op::AddC;
+    case Op::Sub: return constRight ? Op::SubC : Op::RSubC;
+    case Op::Mul: return Op::MulC;
+    case Op::Div: return constRight ? Op::DivC : Op::RDivC;
+    default: return constRight ? Op::PowC : Op::RPowC;
+    }
+}
+
+inline bool hasConstant(Op op) { return op == Op::LoadConst || (op >= Op::AddC && op <= Op::PowInt); }
+
+inline const char* opName(Op op) {
+    static const char* names[] = {"x", "const", "add", "sub", "mul", "div", "pow",
+                                  "addc", "subc", "rsubc", "mulc", "divc", "rdivc", "powc", "rpowc", "powi",
+                                  "neg", "sin", "cos", "exp", "log", "sqrt"};
+    return names[static_cast<int>(op)];
+}
+
+// y = x^power для целого |power| <= kMaxIntPower: возведение в квадрат с умножением
+inline double powInt(double x, int power) {
+    double base = power < 0 ? 1.0 / x : x;
+    double result = 1.0;
+    for (int p = power < 0 ? -power : power; p; p >>= 1) {
+        if (p & 1) result *= base;
+        base *= base;
+    }
+    return result;
+}
+
+} // namespace expression
+
+// Скомпилированное выражение; конструктор бросает std::runtime_error при синтаксической ошибке.
+// Вычисление потокобезопасно: рабочий стек у каждой нити свой.
+class CompiledExpression {
+public:
+    explicit CompiledExpression(const std::string& text) : text_(text) {
+        auto root = expression::Parser(text).parse();
+        size_t depth = 0;
+        emit(*root, depth);
+    }
+
+    const std::string& text() const { return text_; }
+    const std::vector<expression::Instruction>& code() const { return code_; }
+    size_t stackDepth() const { return maxDepth_; }
+
+    // Байткод в одну строку: "x; mulc 2; sin"
+    std::string listing() const {
+        std::ostringstream out;
+        for (size_t k = 0; k < code_.size(); ++k) {
+            const expression::Instruction& ins = code_[k];
+            out << (k ? "; " : "") << expression::opName(ins.op);
+            if (expression::hasConstant(ins.op)) out << ' ' << ins.value;
+        }
+        return out.str();
+    }
+
+    // y[k] = f(x[k]) для k < count, блоками по kBlock
+    void evaluate(const double* x, double* y, size_t count) const {
+        using expression::kBlock;
+        thread_local std::vector<double> stack;
+        if (stack.size() < maxDepth_ * kBlock) stack.resize(maxDepth_ * kBlock);
+        for (size_t k = 0; k < count; k += kBlock) {
+            evaluateBlock(x + k, y + k, count - k < kBlock ? count - k : kBlock, stack.data());
+        }
+    }
+
+    double operator()(double x) const {
+        double y;
+        evaluate(&x, &y, 1);
+        return y;
+    }
+
+private:
+    // Нижний регистр стека — сам выход y, остальные лежат в stack
+    void evaluateBlock(const double* __restrict x, double* y, size_t count, double* stack) const {
+        using namespace expression;
+        size_t top = 0; // число занятых регистров
+        auto reg = [&](size_t r) { return r == 0 ? y : stack + r * kBlock; };
+
+        for (const Instruction& ins : code_) {
+            const double c = ins.value;
+            if (ins.op == Op::LoadX || ins.op == Op::LoadConst) {
+                double* __restrict out = reg(top++);
+                if (ins.op == Op::LoadX) {
+#pragma omp simd
+                    for (size_t k = 0; k < count; ++k) out[k] = x[k];
+                }
+                else {
+#pragma omp simd
+                    for (size_t k = 0; k < count; ++k) out[k] = c;
+                }
+                continue;
+            }
+            if (ins.op <= Op::Pow) {
+                double* __restrict l = reg(top - 2);
+                const double* __restrict r = reg(top - 1);
+                --top;
+                switch (ins.op) {
+                case Op::Add:
+#pragma omp simd
+                    for (size_t k = 0; k < count; ++k) l[k] += r[k];
+                    break;
+                case Op::Sub:
+#pragma omp simd
+                    for (size_t k = 0; k < count; ++k) l[k] -= r[k];
+                    break;
+                case Op::Mul:
+#pragma omp simd
+                    for (size_t k = 0; k < count; ++k) l[k] *= r[k];
+                    break;
+                case Op::Div:
+#pragma omp simd
+                    for (size_t k = 0; k < count; ++k) l[k] /= r[k];
+                    break;
+                default:
+#pragma omp simd
+                    for (size_t k = 0; k < count; ++k) l[k] = std::pow(l[k], r[k]);
+                    break;
+                }
+                continue;
+            }
+
+            double* __restrict v = reg(top - 1);
+            switch (ins.op) {
+            case Op::AddC:
+#pragma omp simd
+                for (size_t k = 0; k < count; ++k) v[k] += c;
+                break;
+            case Op::SubC:
+#pragma omp simd
+                for (size_t k = 0; k < count; ++k) v[k] -= c;
+                break;
+            case Op::RSubC:
+#pragma omp simd
+                for (size_t k = 0; k < count; ++k) v[k] = c - v[k];
+                break;
+            case Op::MulC:
+#pragma omp simd
+                for (size_t k = 0; k < count; ++k) v[k] *= c;
+                break;
+            case Op::DivC:
+#pragma omp simd
+                for (size_t k = 0; k < count; ++k) v[k] /= c;
+                break;
+            case Op::RDivC:
+#pragma omp simd
+                for (size_t k = 0; k < count; ++k) v[k] = c / v[k];
+                break;
+            case Op::PowC:
+#pragma omp simd
+                for (size_t k = 0; k < count; ++k) v[k] = std::pow(v[k], c);
+                break;
+            case Op::RPowC:
+#pragma omp simd
+                for (size_t k = 0; k < count; ++k) v[k] = std::pow(c, v[k]);
+                break;
+            case Op::PowInt: {
+                const int power = static_cast<int>(c);
+#pragma omp simd
+                for (size_t k = 0; k < count; ++k) v[k] = powInt(v[k], power);
+                break;
+            }
+            case Op::Neg:
+#pragma omp simd
+                for (size_t k = 0; k < count; ++k) v[k] = -v[k];
+                break;
+            case Op::Sin:
+#pragma omp simd
+                for (size_t k = 0; k < count; ++k) v[k] = std::sin(v[k]);
+                break;
+            case Op::Cos:
+#pragma omp simd
+                for (size_t k = 0; k < count; ++k) v[k] = std::cos(v[k]);
+                break;
+            case Op::Exp:
+#pragma omp simd
+                for (size_t k = 0; k < count; ++k) v[k] = std::exp(v[k]);
+                break;
+            case Op::Log:
+#pragma omp simd
+                for (size_t k = 0; k < count; ++k) v[k] = std::log(v[k]);
+                break;
+            default:
+#pragma omp simd
+                for (size_t k = 0; k < count; ++k) v[k] = std::sqrt(v[k]);
+                break;
+            }
+        }
+    }
+
+    void push(expression::Op op, double value, size_t& depth, int change) {
+        code_.push_back({op, value});
+        depth += change;
+        if (depth > maxDepth_) maxDepth_ = depth;
+    }
+
+    // Генерация кода для поддерева; depth — текущая глубина стека
+    void emit(const expression::Node& node, size_t& depth) {
+        using namespace expression;
+        if (node.op == Op::LoadX || node.op == Op::LoadConst) {
+            push(node.op, node.value, depth, +1);
+            return;
+        }
+        if (!node.right) {
+            emit(*node.left, depth);
+            push(node.op, 0.0, depth, 0);
+            return;
+        }
+
+        // Константы после свёртки остаются только с одной стороны и встраиваются в инструкцию
+        if (node.right->isConst()) {
+            emit(*node.left, depth);
+            double c = node.right->value;
+            if (node.op == Op::Pow && c == std::floor(c) && std::fabs(c) <= kMaxIntPower) {
+                push(c == 1.0 ? Op::MulC : Op::PowInt, c == 1.0 ? 1.0 : c, depth, 0);
+            }
+            else {
+                push(withConstant(node.op, true), c, depth, 0);
+            }
+            return;
+        }
+        if (node.left->isConst()) {
+            emit(*node.right, depth);
+            push(withConstant(node.op, false), node.left->value, depth, 0);
+            return;
+        }
+        // Более глубокое поддерево первым, если порядок операндов не важен: стек короче
+        if (isCommutative(node.op) && height(*node.right) > height(*node.left)) {
+            emit(*node.right, depth);
+            emit(*node.left, depth);
+        }
+        else {
+            emit(*node.left, depth);
+            emit(*node.right, depth);
+        }
+        push(node.op, 0.0, depth, -1);
+    }
+
+    static size_t height(const expression::Node& node) {
+        size_t l = node.left ? height(*node.left) : 0;
+        size_t r = node.right ? height(*node.right) : 0;
+        return 1 + (l > r ? l : r);
+    }
+
+    std::string text_;
+    std::vector<expression::Instruction> code_;
+    size_t maxDepth_ = 0;
+};
+
+// Метод правых прямоугольников для выражения: x_i = a + i * h вычисляются листьями
+// deterministicSum, и каждый лист из kLeafSize точек проходит байткод блоками по kBlock.
+// Дерево сложения то же, что у integrateParallelT, результат не зависит от числа нитей.
+inline double integrateExpression(const CompiledExpression& f, double a, double b, long long n) {
+    using expression::kBlock;
+    const double h = (b - a) / n;
+    double sum = deterministicSumOfLeaves(1, n + 1, [&](int64_t begin, int64_t end) {
+        alignas(64) double x[kBlock], y[kBlock];
+        double leaf = 0.0;
+        for (int64_t i = begin; i < end; i += kBlock) {
+            const size_t count = end - i < (int64_t)kBlock ? end - i : kBlock;
+#pragma omp simd
+            for (size_t k = 0; k < count; ++k) x[k] = a + (i + (int64_t)k) * h;
+            f.evaluate(x, y, count);
+#pragma omp simd reduction(+:leaf)
+            for (size_t k = 0; k < count; ++k) leaf += y[k];
+        }
+        return leaf;
+    });
+    return sum * h;
+}
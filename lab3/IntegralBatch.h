@@ -0,0 +1,150 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <map>
+#include <numeric>
+#include <string>
+#include <vector>
+#include <omp.h>
+
+#include "Integrands.h"
+
+// Пакетное вычисление многих интегралов методом правых прямоугольников.
+//
+// Данные хранятся как структура массивов (a[], b[], n[], result[]), и SIMD-дорожки
+// соответствуют разным интегралам: на каждом шаге t вектор из kLanes точек
+// x_l = a_l + (begin_l + t) * h_l вычисляется одним векторным вызовом F::eval.
+//
+// Каждый интеграл режется на куски по kChunk слагаемых. Куски сортируются по длине
+// и группируются по kLanes, так что у дорожек одной группы почти одинаковая длина
+// и маскированный хвост короткий. Группы раздаются нитям динамически (schedule(dynamic)),
+// поэтому смесь из очень разных n не оставляет нити без работы. Суммы кусков складываются
+// в порядке их номеров, результат не зависит от числа нитей и расписания.
+
+namespace integral_batch {
+
+constexpr size_t kLanes = 32;
+constexpr long long kChunk = 1LL << 16;
+
+// Кусок интеграла: слагаемые i из [begin, end)
+struct Piece {
+    size_t integral;
+    long long begin;
+    long long end;
+};
+
+// Суммы count <= kLanes кусков одной группы; недостающие дорожки пустые
+template <typename F>
+void sumGroup(const Piece* pieces, size_t count, const double* a, const double* h, double* sums) {
+    // x_l(t) = base_l + t * step_l, t < length_l
+    alignas(64) double base[kLanes], step[kLanes], acc[kLanes];
+    alignas(64) long long length[kLanes];
+    long long common = count == kLanes ? pieces[0].end - pieces[0].begin : 0;
+    long long longest = 0;
+    for (size_t l = 0; l < kLanes; ++l) {
+        const Piece& p = pieces[l < count ? l : 0];
+        step[l] = h[p.integral];
+        base[l] = a[p.integral] + p.begin * step[l];
+        length[l] = l < count ? p.end - p.begin : 0;
+        acc[l] = 0.0;
+        common = std::min(common, length[l]);
+        longest = std::max(longest, length[l]);
+    }
+
+    // Общая часть: все дорожки активны
+    for (long long t = 0; t < common; ++t) {
+#pragma omp simd aligned(base, step, acc : 64)
+        for (size_t l = 0; l < kLanes; ++l) acc[l] += F::eval(base[l] + t * step[l]);
+    }
+    // Хвост: закончившиеся дорожки маскируются
+    for (long long t = common; t < longest; ++t) {
+#pragma omp simd aligned(base, step, acc, length : 64)
+        for (size_t l = 0; l < kLanes; ++l) {
+            double value = F::eval(base[l] + t * step[l]);
+            acc[l] += t < length[l] ? value : 0.0;
+        }
+    }
+    for (size_t l = 0; l < count; ++l) sums[l] = acc[l];
+}
+
+} // namespace integral_batch
+
+// Интегралы F на [a[k], b[k]] по n[k] отрезкам для k < count; значения пишутся в result[k]
+template <typename F>
+void integrateBatchT(const double* a, const double* b, const long long* n, double* result, size_t count) {
+    using namespace integral_batch;
+    std::vector<double> h(count);
+    std::vector<Piece> pieces;
+    for (size_t k = 0; k < count; ++k) {
+        h[k] = n[k] > 0 ? (b[k] - a[k]) / n[k] : 0.0;
+        for (long long i = 1; i <= n[k]; i += kChunk) pieces.push_back({k, i, std::min(i + kChunk, n[k] + 1)});
+    }
+
+    // Порядок обработки: по убыванию длины куска (полные куски вперёд, хвосты вместе)
+    std::vector<size_t> order(pieces.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](size_t x, size_t y) {
+        return pieces[x].end - pieces[x].begin > pieces[y].end - pieces[y].begin;
+    });
+    std::vector<Piece> sorted(pieces.size());
+    for (size_t q = 0; q < order.size(); ++q) sorted[q] = pieces[order[q]];
+
+    std::vector<double> sortedSums(pieces.size());
+    const long long groups = (pieces.size() + kLanes - 1) / kLanes;
+#pragma omp parallel for schedule(dynamic, 1)
+    for (long long g = 0; g < groups; ++g) {
+        size_t offset = g * kLanes;
+        sumGroup<F>(sorted.data() + offset, std::min(kLanes, sorted.size() - offset), a, h.data(),
+                    sortedSums.data() + offset);
+    }
+
+    // Суммы кусков каждого интеграла складываются в исходном порядке кусков
+    std::vector<double> pieceSums(pieces.size());
+    for (size_t q = 0; q < order.size(); ++q) pieceSums[order[q]] = sortedSums[q];
+    std::fill(result, result + count, 0.0);
+    for (size_t q = 0; q < pieces.size(); ++q) result[pieces[q].integral] += pieceSums[q];
+    for (size_t k = 0; k < count; ++k) result[k] *= h[k];
+}
+
+// Набор интегралов в виде структуры массивов; функция задаётся именем, как в меню Program3
+struct IntegralBatch {
+    std::vector<std::string> func;
+    std::vector<double> a;
+    std::vector<double> b;
+    std::vector<long long> n;
+    std::vector<double> result;
+
+    void add(const std::string& f, double from, double to, long long count) {
+        func.push_back(f);
+        a.push_back(from);
+        b.push_back(to);
+        n.push_back(count);
+    }
+    size_t size() const { return a.size(); }
+};
+
+// Вычисление всего набора: интегралы группируются по функции, каждая группа считается
+// integrateBatchT. Возвращает false, если встретилась неизвестная функция.
+inline bool integrateBatch(IntegralBatch& batch) {
+    batch.result.assign(batch.size(), 0.0);
+    std::map<std::string, std::vector<size_t>> byFunction;
+    for (size_t k = 0; k < batch.size(); ++k) byFunction[batch.func[k]].push_back(k);
+
+    for (const auto& [name, indices] : byFunction) {
+        // Сбор группы в непрерывные массивы
+        std::vector<double> a(indices.size()), b(indices.size()), result(indices.size());
+        std::vector<long long> n(indices.size());
+        for (size_t q = 0; q < indices.size(); ++q) {
+            a[q] = batch.a[indices[q]];
+            b[q] = batch.b[indices[q]];
+            n[q] = batch.n[indices[q]];
+        }
+        bool known = withIntegrand(name, [&](auto fn) {
+            integrateBatchT<decltype(fn)>(a.data(), b.data(), n.data(), result.data(), indices.size());
+        });
+        if (!known) return false;
+        for (size_t q = 0; q < indices.size(); ++q) batch.result[indices[q]] = result[q];
+    }
+    return true;
+}
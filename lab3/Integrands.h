@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <string>
+#include <omp.h>
+
+#include "../common/DeterministicSum.h"
+
+// Встроенные подынтегральные функции как типы-функторы
+// (eval — значение, primitive — первообразная для проверки точности).
+// Функция выбирается один раз по имени (withIntegrand), дальше интегратор
+// инстанцируется под конкретный тип: в цикле нет сравнения строк и косвенных
+// вызовов, и компилятор может векторизовать его целиком.
+
+#if defined(HAVE_LIBMVEC)
+// Векторные варианты sin/cos/exp/log/pow из libmvec (glibc объявляет их только при -ffast-math)
+extern "C" {
+__attribute__((simd("notinbranch"))) double sin(double) noexcept;
+__attribute__((simd("notinbranch"))) double cos(double) noexcept;
+__attribute__((simd("notinbranch"))) double exp(double) noexcept;
+__attribute__((simd("notinbranch"))) double log(double) noexcept;
+__attribute__((simd("notinbranch"))) double pow(double, double) noexcept;
+}
+#endif
+
+struct SquareFn {
+    static const char* name() { return "x*x"; }
+    static double eval(double x) { return x * x; }
+    static double primitive(double x) { return x * x * x / 3.0; }
+};
+
+struct SinFn {
+    static const char* name() { return "sin(x)"; }
+    static double eval(double x) { return std::sin(x); }
+    static double primitive(double x) { return -std::cos(x); }
+};
+
+struct CosFn {
+    static const char* name() { return "cos(x)"; }
+    static double eval(double x) { return std::cos(x); }
+    static double primitive(double x) { return std::sin(x); }
+};
+
+struct ExpFn {
+    static const char* name() { return "exp(x)"; }
+    static double eval(double x) { return std::exp(x); }
+    static double primitive(double x) { return std::exp(x); }
+};
+
+struct SqrtFn {
+    static const char* name() { return "sqrt(x)"; }
+    static double eval(double x) { return std::sqrt(x); }
+    static double primitive(double x) { return 2.0 / 3.0 * x * std::sqrt(x); }
+};
+
+struct LorentzFn {
+    static const char* name() { return "1/(1+x*x)"; }
+    static double eval(double x) { return 1.0 / (1.0 + x * x); }
+    static double primitive(double x) { return std::atan(x); }
+};
+
+// Пакетное вычисление y[k] = F(x[k]) в SIMD-цикле
+template <typename F>
+void evalBatch(const double* x, double* y, size_t count) {
+#pragma omp simd
+    for (size_t k = 0; k < count; ++k) y[k] = F::eval(x[k]);
+}
+
+// Выбор функтора по имени из меню; visitor вызывается с экземпляром функтора.
+// Возвращает false, если функция неизвестна.
+template <typename Visitor>
+bool withIntegrand(const std::string& func, Visitor visitor) {
+    if (func == SquareFn::name()) visitor(SquareFn{});
+    else if (func == SinFn::name()) visitor(SinFn{});
+    else if (func == CosFn::name()) visitor(CosFn{});
+    else if (func == ExpFn::name()) visitor(ExpFn{});
+    else if (func == SqrtFn::name()) visitor(SqrtFn{});
+    else if (func == LorentzFn::name()) visitor(LorentzFn{});
+    else return false;
+    return true;
+}
+
+// Последовательное вычисление методом правых прямоугольников для функтора F
+template <typename F>
+double integrateSequentialT(double a, double b, long long n) {
+    double h = (b - a) / n;
+    double sum = 0.0;
+
+#pragma omp simd reduction(+:sum)
+    for (long long i = 1; i <= n; ++i) {
+        sum += F::eval(a + i * h);
+    }
+
+    return sum * h;
+}
+
+// Параллельное вычисление для функтора F: нити берут блоки, внутри блока SIMD,
+// суммы блоков складываются фиксированным деревом (воспроизводимо при любом числе нитей)
+template <typename F>
+double integrateParallelT(double a, double b, long long n) {
+    double h = (b - a) / n;
+    double sum = deterministicSum(1, n + 1, [=](long long i) { return F::eval(a + i * h); });
+    return sum * h;
+}
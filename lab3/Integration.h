@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cmath>
+#include <iostream>
+#include <string>
+
+#include "../common/DeterministicSum.h"
+
+// Исходные интеграторы методом правых прямоугольников с выбором функции по строке
+
+// Функция, которую будем интегрировать
+inline double f(double x, const std::string& func) {
+    if (func == "x*x") return x * x;
+    else if (func == "sin(x)") return std::sin(x);
+    else if (func == "cos(x)") return std::cos(x);
+    else if (func == "exp(x)") return std::exp(x);
+    else if (func == "sqrt(x)") return std::sqrt(x);
+    else if (func == "1/(1+x*x)") return 1.0 / (1.0 + x * x);
+    else {
+        std::cerr << "Unknown function. Using default: x*x\n";
+        return x * x;
+    }
+}
+
+// Последовательное вычисление
+inline double integrateSequential(double a, double b, long long n, const std::string& func) {
+    double h = (b - a) / n;
+    double sum = 0.0;
+
+    for (long long i = 1; i <= n; ++i) {
+        double x = a + i * h;
+        sum += f(x, func);
+    }
+
+    return sum * h;
+}
+
+// Параллельное вычисление с OpenMP.
+// Сумма складывается фиксированным деревом блоков, поэтому результат
+// не зависит от числа нитей и расписания.
+inline double integrateParallel(double a, double b, long long n, const std::string& func) {
+    double h = (b - a) / n;
+    double sum = deterministicSum(1, n + 1, [&](long long i) {
+        double x = a + i * h;
+        return f(x, func);
+    });
+
+    return sum * h;
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+#include <mpi.h>
+#include <omp.h>
+
+#include "../common/DeterministicSum.h"
+
+// Гибридный режим MPI+OpenMP для метода правых прямоугольников.
+//
+// Слагаемые i = 1..n разбиты на блоки deterministicSum фиксированного размера.
+// Каждый процесс получает непрерывный диапазон блоков (т. е. непрерывный подотрезок [a, b])
+// и считает суммы своих блоков OpenMP-ядром. Суммы блоков собираются на процесс 0
+// (MPI_Gatherv) и складываются тем же попарным деревом, что и в deterministicSum, поэтому
+// результат побитово совпадает с integrateParallelT и не зависит от числа процессов и нитей.
+// Передаётся одно число на блок (n / 65536 чисел), что мало по сравнению с вычислениями.
+//
+// При weighted = true блоки делятся пропорционально измеренной производительности
+// процессов: каждый процесс сначала считает несколько пробных блоков, скорости собираются
+// MPI_Allgather, и границы диапазонов ставятся по накопленным долям.
+
+struct MpiIntegrationStats {
+    int64_t blocks = 0;        // блоков у процесса
+    double throughput = 0.0;   // пробная скорость, блоков/с (0, если не замерялась)
+    double computeTime = 0.0;
+    double commTime = 0.0;
+};
+
+namespace integration_mpi {
+
+constexpr int64_t kProbeBlocks = 4;
+
+// Границы диапазонов блоков: равные доли или пропорционально весам
+inline std::vector<int64_t> splitBlocks(int64_t blocks, const std::vector<double>& weights) {
+    const size_t size = weights.size();
+    std::vector<int64_t> bounds(size + 1, 0);
+    double total = 0.0;
+    for (double w : weights) total += w;
+    double accumulated = 0.0;
+    for (size_t r = 0; r < size; ++r) {
+        accumulated += weights[r];
+        bounds[r + 1] = total > 0 ? std::min<int64_t>(blocks, (int64_t)(blocks * (accumulated / total) + 0.5))
+                                  : blocks * (int64_t)(r + 1) / (int64_t)size;
+    }
+    bounds[size] = blocks;
+    return bounds;
+}
+
+} // namespace integration_mpi
+
+// Интеграл F на [a, b] по n правым прямоугольникам; вызывается всеми процессами между
+// MPI_Init и MPI_Finalize, значение возвращается на процессе 0, статистика — на каждом
+template <typename F>
+double integrateMpiT(double a, double b, long long n, bool weighted, MpiIntegrationStats& stats) {
+    using namespace deterministic_sum;
+    int rank = 0, size = 1;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    const double h = (b - a) / n;
+    auto term = [=](long long i) { return F::eval(a + i * h); };
+    const int64_t first = 1, last = n + 1;
+    const int64_t blocks = blockCount(first, last);
+
+    // Весовое разбиение: пробные блоки из середины отрезка, чтобы не попасть на особенности у краёв
+    std::vector<double> weights(size, 1.0);
+    if (weighted && blocks > 0) {
+        const int64_t probeBegin = blocks / 2;
+        const int64_t probeEnd = std::min(blocks, probeBegin + integration_mpi::kProbeBlocks);
+        std::vector<double> probe(probeEnd - probeBegin);
+        double start = MPI_Wtime();
+        blockSums(first, last, probeBegin, probeEnd, term, probe.data());
+        stats.throughput = (probeEnd - probeBegin) / std::max(MPI_Wtime() - start, 1e-9);
+        MPI_Allgather(&stats.throughput, 1, MPI_DOUBLE, weights.data(), 1, MPI_DOUBLE, MPI_COMM_WORLD);
+    }
+    const std::vector<int64_t> bounds = integration_mpi::splitBlocks(blocks, weights);
+    const int64_t blockBegin = bounds[rank], blockEnd = bounds[rank + 1];
+    stats.blocks = blockEnd - blockBegin;
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    double start = MPI_Wtime();
+    std::vector<double> local(stats.blocks);
+    blockSums(first, last, blockBegin, blockEnd, term, local.data());
+    stats.computeTime = MPI_Wtime() - start;
+
+    // Сбор сумм блоков в порядке номеров блоков
+    start = MPI_Wtime();
+    std::vector<int> counts(size), displs(size);
+    for (int r = 0; r < size; ++r) {
+        counts[r] = (int)(bounds[r + 1] - bounds[r]);
+        displs[r] = (int)bounds[r];
+    }
+    std::vector<double> all(rank == 0 ? blocks : 0);
+    MPI_Gatherv(local.data(), (int)stats.blocks, MPI_DOUBLE, all.data(), counts.data(), displs.data(),
+                MPI_DOUBLE, 0, MPI_COMM_WORLD);
+    double value = rank == 0 ? pairwise(all.data(), all.size()) * h : 0.0;
+    stats.commTime = MPI_Wtime() - start;
+    return value;
+}
@@ -2,61 +2,259 @@
 #include <cmath>
 #include <string>
 #include <map>
+#include <memory>
+#include <random>
+#include <cstring>
+#include <mpi.h>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
 #include <omp.h>
 
+#include "../common/BatchRunner.h"
+#include "../common/DeterministicSum.h"
+#include "AdaptiveQuadrature.h"
+#include "Expression.h"
+#include "IntegralBatch.h"
+#include "Integration.h"
+#include "IntegrationMpi.h"
+#include "Integrands.h"
+
 using namespace std;
 
-// Функция, которую будем интегрировать
-double f(double x, const string& func) {
-    if (func == "x*x") return x * x;
-    else if (func == "sin(x)") return sin(x);
-    else if (func == "cos(x)") return cos(x);
-    else if (func == "exp(x)") return exp(x);
-    else if (func == "sqrt(x)") return sqrt(x);
-    else if (func == "1/(1+x*x)") return 1.0 / (1.0 + x * x);
-    else {
-        cerr << "Unknown function. Using default: x*x\n";
-        return x * x;
-    }
+// Список поддерживаемых функций
+map<int, string> supportedFunctions() {
+    return {
+        {1, "x*x"},
+        {2, "sin(x)"},
+        {3, "cos(x)"},
+        {4, "exp(x)"},
+        {5, "sqrt(x)"},
+        {6, "1/(1+x*x)"}
+    };
+}
+
+// Задание пакетного режима; буфер сумм блоков переиспользуется между заданиями
+struct IntegralJob {
+    string func;
+    double a = 0.0, b = 0.0;
+    long long n = 0;
+    double result = 0.0;
+    vector<double> partial;
+};
+
+// Пакетный режим: по строке "функция a b n" на задание (функция — имя или номер из меню),
+// результат — строка "номер функция a b n значение время_мкс"
+int runBatchMode(istream& in) {
+    const map<int, string> functions = supportedFunctions();
+    IntegralJob job;
+    size_t count = runBatch(in, cout, job,
+        [&](const string& line, IntegralJob& job) {
+            istringstream fields(line);
+            if (!(fields >> job.func >> job.a >> job.b >> job.n) || job.n <= 0 || job.b <= job.a) {
+                throw runtime_error("ожидается \"функция a b n\" с n > 0 и b > a");
+            }
+            if (job.func.find_first_not_of("0123456789") == string::npos) {
+                auto byNumber = functions.find(atoi(job.func.c_str()));
+                if (byNumber != functions.end()) job.func = byNumber->second;
+            }
+            if (!withIntegrand(job.func, [](auto) {})) throw runtime_error("неизвестная функция " + job.func);
+            size_t blocks = deterministic_sum::blockCount(1, job.n + 1);
+            if (job.partial.size() < blocks) job.partial.resize(blocks);
+        },
+        [](IntegralJob& job) {
+            // Та же сумма, что в integrateParallelT, но на уже созданной команде нитей
+            withIntegrand(job.func, [&](auto fn) {
+                using F = decltype(fn);
+                const double a = job.a, h = (job.b - job.a) / job.n;
+                double sum = deterministic_sum::teamSum(1, job.n + 1, [=](long long i) {
+                    return F::eval(a + i * h);
+                }, job.partial.data());
+#pragma omp master
+                job.result = sum * h;
+            });
+        },
+        [](size_t index, const IntegralJob& job, double seconds, ostream& out) {
+            out << index << ' ' << job.func << ' ' << job.a << ' ' << job.b << ' ' << job.n << ' '
+                << setprecision(17) << job.result << setprecision(6) << ' ' << seconds * 1e6 << '\n';
+        });
+    cerr << "Выполнено заданий: " << count << endl;
+    return 0;
 }
 
-// Последовательное вычисление
-double integrateSequential(double a, double b, int n, const string& func) {
-    double h = (b - a) / n;
-    double sum = 0.0;
+// Распределённый режим: mpirun -np N Program3 --mpi [--weighted] функция a b n
+int runMpiMode(int argc, char* argv[]) {
+    int provided = 0;
+    MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED, &provided);
+    int rank = 0, size = 1;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    int arg = 2;
+    bool weighted = argc > arg && strcmp(argv[arg], "--weighted") == 0;
+    if (weighted) ++arg;
+    string func = argc > arg ? argv[arg] : "";
+    if (func.find_first_not_of("0123456789") == string::npos && !func.empty()) {
+        func = supportedFunctions()[atoi(func.c_str())];
+    }
+    double a = argc > arg + 1 ? atof(argv[arg + 1]) : 0.0;
+    double b = argc > arg + 2 ? atof(argv[arg + 2]) : 1.0;
+    long long n = argc > arg + 3 ? atoll(argv[arg + 3]) : 100000000LL;
 
-    for (int i = 1; i <= n; ++i) {
-        double x = a + i * h;
-        sum += f(x, func);
+    MpiIntegrationStats stats;
+    double value = 0.0, exact = 0.0, reference = 0.0;
+    bool checked = false;
+    bool known = n > 0 && b > a && withIntegrand(func, [&](auto fn) {
+        using F = decltype(fn);
+        value = integrateMpiT<F>(a, b, n, weighted, stats);
+        exact = F::primitive(b) - F::primitive(a);
+        // Для умеренных n сверяемся с однопроцессной версией
+        if (rank == 0 && n <= 100000000LL) {
+            reference = integrateParallelT<F>(a, b, n);
+            checked = true;
+        }
+    });
+    if (!known) {
+        if (rank == 0) cerr << "Использование: Program3 --mpi [--weighted] функция a b n (n > 0, b > a)" << endl;
+        MPI_Finalize();
+        return -1;
     }
 
-    return sum * h;
+    // Статистика по процессам
+    double local[4] = {(double)stats.blocks, stats.throughput, stats.computeTime, stats.commTime};
+    vector<double> all(rank == 0 ? 4 * size : 0);
+    MPI_Gather(local, 4, MPI_DOUBLE, all.data(), 4, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+    if (rank == 0) {
+        cout << "Процессов MPI: " << size << ", нитей OpenMP на процесс: " << omp_get_max_threads()
+             << ", разбиение: " << (weighted ? "по производительности" : "равное") << endl;
+        for (int r = 0; r < size; ++r) {
+            printf("Процесс %d: блоков %.0f, пробная скорость %.1f блоков/с, вычисления %.6f с, обмен %.6f с\n",
+                   r, all[4 * r], all[4 * r + 1], all[4 * r + 2], all[4 * r + 3]);
+        }
+        cout << setprecision(17) << "Результат: " << value << endl;
+        cout << setprecision(6) << "Погрешность по первообразной: " << abs(value - exact) << endl;
+        if (checked) {
+            cout << "Совпадает с однопроцессной версией побитово: " << (value == reference ? "да" : "нет") << endl;
+        }
+    }
+    MPI_Finalize();
+    return 0;
 }
 
-// Параллельное вычисление с OpenMP
-double integrateParallel(double a, double b, int n, const string& func) {
-    double h = (b - a) / n;
-    double sum = 0.0;
+// Перебор параметров: count интегралов одной функции со случайными [a, b] и n от 10 до maxN
+// (равномерно по порядку величины), по одному вызову integrateParallelT против пакетного integrateBatch
+int runSweepMode(long long count, string func, long long maxN) {
+    if (func.find_first_not_of("0123456789") == string::npos && !func.empty()) {
+        func = supportedFunctions()[atoi(func.c_str())];
+    }
+    if (count <= 0 || !withIntegrand(func, [](auto) {})) {
+        cerr << "Использование: Program3 --sweep количество функция [максимальное n]" << endl;
+        return -1;
+    }
+    mt19937_64 rng(2024);
+    uniform_real_distribution<double> start(0.0, 1.0), length(0.5, 2.0), logN(1.0, log10((double)max(maxN, 10LL)));
+    IntegralBatch batch;
+    long long samples = 0;
+    for (long long k = 0; k < count; ++k) {
+        double a = start(rng);
+        long long n = (long long)pow(10.0, logN(rng));
+        batch.add(func, a, a + length(rng), n);
+        samples += n;
+    }
+
+    vector<double> single(count);
+    double time_single = 0.0;
+    withIntegrand(func, [&](auto fn) {
+        using F = decltype(fn);
+        double start_time = omp_get_wtime();
+        for (long long k = 0; k < count; ++k) single[k] = integrateParallelT<F>(batch.a[k], batch.b[k], batch.n[k]);
+        time_single = omp_get_wtime() - start_time;
+    });
+
+    double start_time = omp_get_wtime();
+    integrateBatch(batch);
+    double time_batch = omp_get_wtime() - start_time;
 
-#pragma omp parallel for reduction(+:sum)
-    for (int i = 1; i <= n; ++i) {
-        double x = a + i * h;
-        sum += f(x, func);
+    double max_diff = 0.0;
+    for (long long k = 0; k < count; ++k) {
+        max_diff = max(max_diff, abs(batch.result[k] - single[k]) / max(1.0, abs(single[k])));
+    }
+    cout << "Интегралов: " << count << ", функция " << func << ", всего отсчётов: " << samples << endl;
+    cout << "По одному (integrateParallelT): " << time_single << " с, " << samples / time_single << " отсчётов/с\n";
+    cout << "Пакетно (integrateBatch):       " << time_batch << " с, " << samples / time_batch << " отсчётов/с\n";
+    cout << "Максимальное относительное расхождение: " << max_diff << endl;
+    return 0;
+}
+
+// Интеграл выражения, заданного строкой: Program3 --expr "выражение" a b n.
+// Если выражение совпадает с именем встроенной функции, для сравнения считается и integrateParallelT.
+int runExpressionMode(const string& text, double a, double b, long long n) {
+    if (n <= 0 || b <= a) {
+        cerr << "Ошибка: n должно быть положительным, и b > a." << endl;
+        return -1;
     }
+    double start_time = omp_get_wtime();
+    unique_ptr<CompiledExpression> f;
+    try {
+        f = make_unique<CompiledExpression>(text);
+    }
+    catch (const exception& e) {
+        cerr << "Ошибка: " << e.what() << endl;
+        return -1;
+    }
+    double time_compile = omp_get_wtime() - start_time;
+
+    start_time = omp_get_wtime();
+    double result = integrateExpression(*f, a, b, n);
+    double time_expr = omp_get_wtime() - start_time;
+
+    cout << "Выражение: " << f->text() << endl;
+    cout << "Байткод (" << f->code().size() << " инструкций, глубина стека " << f->stackDepth() << "): "
+         << f->listing() << endl;
+    cout << "Компиляция: " << time_compile * 1e6 << " мкс" << endl;
+    cout << "Результат: " << result << endl;
+    cout << "Время: " << time_expr << " с, " << n / time_expr << " отсчётов/с" << endl;
 
-    return sum * h;
+    withIntegrand(text, [&](auto fn) {
+        using F = decltype(fn);
+        start_time = omp_get_wtime();
+        double builtin = integrateParallelT<F>(a, b, n);
+        double time_builtin = omp_get_wtime() - start_time;
+        cout << "Встроенная функция: " << builtin << ", " << n / time_builtin << " отсчётов/с (байткод медленнее в "
+             << time_expr / time_builtin << " раза), расхождение " << abs(result - builtin) << endl;
+    });
+    return 0;
 }
 
-int main() {
-    // Список поддерживаемых функций
-    map<int, string> functions = {
-        {1, "x*x"},
-        {2, "sin(x)"},
-        {3, "cos(x)"},
-        {4, "exp(x)"},
-        {5, "sqrt(x)"},
-        {6, "1/(1+x*x)"}
-    };
+int main(int argc, char* argv[]) {
+    // Своя функция: Program3 --expr "выражение" a b n
+    if (argc >= 6 && string(argv[1]) == "--expr") {
+        return runExpressionMode(argv[2], atof(argv[3]), atof(argv[4]), atoll(argv[5]));
+    }
+    // Пакет интегралов: Program3 --sweep количество функция [максимальное n]
+    if (argc >= 4 && string(argv[1]) == "--sweep") {
+        return runSweepMode(atoll(argv[2]), argv[3], argc >= 5 ? atoll(argv[4]) : 10000);
+    }
+    if (argc >= 2 && string(argv[1]) == "--mpi") {
+        return runMpiMode(argc, argv);
+    }
+
+    // Пакетный режим: Program3 --batch [jobs.txt] (без файла задания читаются из stdin)
+    if (argc >= 2 && string(argv[1]) == "--batch") {
+        if (argc >= 3) {
+            ifstream jobs(argv[2]);
+            if (!jobs) {
+                cerr << "Не удалось открыть файл: " << argv[2] << endl;
+                return -1;
+            }
+            return runBatchMode(jobs);
+        }
+        return runBatchMode(cin);
+    }
+
+    map<int, string> functions = supportedFunctions();
 
     // Ввод данных от пользователя
     int choice;
@@ -74,7 +272,7 @@ int main() {
     }
 
     double a, b;
-    int n;
+    long long n;
 
     cout << "Введите начало интервала a: ";
     cin >> a;
@@ -113,5 +311,64 @@ int main() {
     // Разница между результатами
     cout << "Разница между результатами: " << abs(result_par - result_seq) << endl;
 
+    // Версии, специализированные под функцию на этапе компиляции
+    double time_seq = 0.0, time_par = 0.0;
+    double result_seq_t = 0.0, result_par_t = 0.0;
+    double time_legacy_seq = 0.0, time_legacy_par = 0.0;
+    withIntegrand(func, [&](auto fn) {
+        using F = decltype(fn);
+        start_time = omp_get_wtime();
+        result_seq_t = integrateSequentialT<F>(a, b, n);
+        time_seq = omp_get_wtime() - start_time;
+
+        start_time = omp_get_wtime();
+        result_par_t = integrateParallelT<F>(a, b, n);
+        time_par = omp_get_wtime() - start_time;
+    });
+    // Повторный замер исходных версий для сравнения пропускной способности
+    start_time = omp_get_wtime();
+    integrateSequential(a, b, n, func);
+    time_legacy_seq = omp_get_wtime() - start_time;
+    start_time = omp_get_wtime();
+    integrateParallel(a, b, n, func);
+    time_legacy_par = omp_get_wtime() - start_time;
+
+    cout << "\n--- Специализированные интеграторы (SIMD) ---\n";
+    cout << "Результат (последовательно): " << result_seq_t << endl;
+    cout << "Результат (параллельно): " << result_par_t << endl;
+    cout << "Разница с исходной версией: " << abs(result_par_t - result_seq) << endl;
+    cout << "Пропускная способность, отсчётов/с:\n";
+    cout << "  последовательно: " << n / time_legacy_seq << " (строки) -> " << n / time_seq << " (шаблон)\n";
+    cout << "  параллельно:     " << n / time_legacy_par << " (строки) -> " << n / time_par << " (шаблон)\n";
+
+    // Адаптивные методы (необязательно): при вводе 0 0 или конце ввода пропускаются
+    AdaptiveOptions options;
+    cout << "\nВведите абсолютную и относительную точность для адаптивных методов (0 0 — пропустить): ";
+    if (!(cin >> options.absTol >> options.relTol) || (options.absTol <= 0 && options.relTol <= 0)) {
+        cout << endl;
+        return 0;
+    }
+
+    withIntegrand(func, [&](auto fn) {
+        using F = decltype(fn);
+        double exact = F::primitive(b) - F::primitive(a);
+
+        start_time = omp_get_wtime();
+        QuadratureResult simpson = integrateAdaptiveSimpson<F>(a, b, options);
+        double time_simpson = omp_get_wtime() - start_time;
+
+        start_time = omp_get_wtime();
+        QuadratureResult kronrod = integrateGaussKronrod<F>(a, b, options);
+        double time_kronrod = omp_get_wtime() - start_time;
+
+        cout << "\n--- Адаптивные методы (точное значение " << exact << ") ---\n";
+        cout << "Метод               | вычислений f | время, с | погрешность\n";
+        cout << "Правые прямоуг.     | " << n << " | " << time_legacy_par << " | " << abs(result_par - exact) << endl;
+        cout << "Адаптивный Симпсон  | " << simpson.evaluations << " | " << time_simpson << " | "
+             << abs(simpson.value - exact) << " (оценка " << simpson.errorEstimate << ", глубина " << simpson.depth << ")\n";
+        cout << "Гаусс-Кронрод G7K15 | " << kronrod.evaluations << " | " << time_kronrod << " | "
+             << abs(kronrod.value - exact) << " (оценка " << kronrod.errorEstimate << ", глубина " << kronrod.depth << ")\n";
+    });
+
     return 0;
 }
\ No newline at end of file
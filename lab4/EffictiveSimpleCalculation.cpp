@@ -2,76 +2,158 @@
 #include <cmath>
 #include <omp.h>
 #include <chrono>
-
-// Функция для вычисления f(x) с заданной точностью
-double f(double x, double epsilon) {
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "../common/DeterministicSum.h"
+#include "../common/PerfCounters.h"
+#include "Romberg.h"
+#include "SeriesEvaluator.h"
+#include "Trapezoidal.h"
+
+// Среднее время одного вычисления eval(x) на равномерной сетке из samples точек [a, b], нс
+template <typename Eval>
+double time_per_sample(double a, double b, int samples, Eval eval) {
+    double h = (b - a) / (samples - 1);
     double sum = 0.0;
-    double term = 1.0; // Первый член ряда
-    int n = 1;
-
-    while (fabs(term) > epsilon) {
-        term = pow(-1, n) / (tgamma(2 * n + 1) * (2 * n)) * pow(x, 2 * n);
-        sum += term;
-        n++;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < samples; ++i) {
+        sum += eval(a + i * h);
     }
-
-    return sum;
+    // Пустая вставка asm «использует» сумму: компилятор не выбросит цикл и не перенесёт его за замер
+    asm volatile("" : : "g"(sum) : "memory");
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / samples;
 }
 
-// Последовательный метод трапеций
-double trapezoidal_rule_seq(double a, double b, int N, double epsilon) {
-    double h = (b - a) / N;
-    double sum = 0.0;
-
-    // Вычисляем значения f(a) и f(b)
-    double fa = f(a, epsilon);
-    double fb = f(b, epsilon);
-
-    // Суммируем значения f(x_i) для i = 1, ..., N-1
-    for (int i = 1; i < N; ++i) {
-        double xi = a + i * h;
-        sum += f(xi, epsilon);
+// Сравнение исходной f с рекуррентным, быстрым и табличным вычислением
+void compare_evaluators(double a, double b, double epsilon) {
+    const int samples = 100000;
+
+    auto start_table = std::chrono::high_resolution_clock::now();
+    f_table table(a, b, epsilon);
+    auto end_table = std::chrono::high_resolution_clock::now();
+
+    double ns_f = time_per_sample(a, b, samples, [&](double x) { return f(x, epsilon); });
+    double ns_rec = time_per_sample(a, b, samples, [&](double x) { return f_recurrence(x, epsilon); });
+    double ns_fast = time_per_sample(a, b, samples, [&](double x) { return f_fast(x, epsilon); });
+    double ns_table = time_per_sample(a, b, samples, [&](double x) { return table(x); });
+
+    // Наибольшее отклонение от быстрого вычисления (оно точнее исходного ряда при больших |x|)
+    double max_rec = 0.0, max_f = 0.0, max_table = 0.0;
+    for (int i = 0; i < samples; ++i) {
+        double x = a + i * (b - a) / (samples - 1);
+        double exact = f_fast(x, epsilon);
+        max_f = std::max(max_f, std::fabs(f(x, epsilon) - exact));
+        max_rec = std::max(max_rec, std::fabs(f_recurrence(x, epsilon) - exact));
+        max_table = std::max(max_table, std::fabs(table(x) - exact));
     }
 
-    // Формула метода трапеций
-    return h * (fa + 2 * sum + fb) / 2.0;
+    double table_ms = std::chrono::duration<double, std::milli>(end_table - start_table).count();
+    std::cout << "Вычисление f(x) на " << samples << " точках [" << a << ", " << b << "]:" << std::endl;
+    std::cout << "  исходная f:     " << ns_f << " нс/точку, отклонение " << max_f << std::endl;
+    std::cout << "  рекуррентная:   " << ns_rec << " нс/точку, ускорение " << ns_f / ns_rec
+              << "x, отклонение " << max_rec << std::endl;
+    std::cout << "  ряд + Ci(x):    " << ns_fast << " нс/точку, ускорение " << ns_f / ns_fast << "x" << std::endl;
+    std::cout << "  таблица:        " << ns_table << " нс/точку, ускорение " << ns_f / ns_table
+              << "x, отклонение " << max_table << " (" << table.nodes() << " узлов, построение "
+              << table_ms << " мс)" << std::endl;
 }
 
-// Параллельный метод трапеций с OpenMP
-double trapezoidal_rule_par(double a, double b, int N, double epsilon) {
-    double h = (b - a) / N;
-    double sum = 0.0;
+// Сравнение расписаний параллельного метода трапеций: время, занятость и простой каждой нити,
+// эффективность (доля времени, которую нити считали), и баланс по модели стоимости для 4..64 нитей
+void compare_schedules(double a, double b, long long N, double epsilon) {
+    const struct {
+        SumSchedule schedule;
+        const char* name;
+    } schedules[] = {{SumSchedule::Static, "static"}, {SumSchedule::Dynamic, "dynamic"},
+                     {SumSchedule::CostModel, "модель стоимости"}};
+
+    std::cout << "Расписания метода трапеций, N = " << N << ", нитей " << omp_get_max_threads() << ":" << std::endl;
+    double reference = 0.0;
+    for (const auto& s : schedules) {
+        std::vector<ThreadLoad> loads;
+        auto start = std::chrono::high_resolution_clock::now();
+        double result = trapezoidal_rule_par(a, b, N, epsilon, s.schedule, &loads);
+        double wall = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+        if (s.schedule == SumSchedule::Static) reference = result;
+
+        double busy = 0.0, longest = 0.0, shortest = 1e300;
+        for (const auto& load : loads) {
+            busy += load.busy;
+            longest = std::max(longest, load.busy + load.idle);
+            shortest = std::min(shortest, load.busy);
+        }
+        double efficiency = longest > 0.0 ? busy / (loads.size() * longest) : 1.0;
+        std::cout << "  " << s.name << ": " << wall * 1e3 << " мс, эффективность " << efficiency
+                  << ", занятость нитей " << shortest * 1e3 << ".." << (longest > 0 ? longest * 1e3 : 0.0) << " мс"
+                  << (result == reference ? "" : ", результат отличается!") << std::endl;
+        if (loads.size() <= 16) {
+            for (size_t t = 0; t < loads.size(); ++t) {
+                std::cout << "    нить " << t << ": работа " << loads[t].busy * 1e3 << " мс, простой "
+                          << loads[t].idle * 1e3 << " мс, листьев " << loads[t].leaves << ", стоимость "
+                          << loads[t].cost << std::endl;
+            }
+        }
+    }
 
-    #pragma omp parallel for reduction(+ : sum)
-    for (int i = 1; i < N; ++i) {
-        double xi = a + i * h;
-        sum += f(xi, epsilon);
+    // Баланс по модели: отношение самой загруженной нити к средней (1 — идеально)
+    double h = (b - a) / N;
+    std::vector<double> cost = balanced_sum::leafCosts(1, N, [&](long long begin, long long end) {
+        return (double)series_terms(a + (begin + end) / 2 * h, epsilon) * (end - begin);
+    });
+    std::cout << "  Модельная эффективность (static / модель стоимости):";
+    for (int p : {4, 16, 64}) {
+        std::cout << " p=" << p << ": " << 1.0 / balanced_sum::predictedImbalance(cost, p, SumSchedule::Static)
+                  << " / " << 1.0 / balanced_sum::predictedImbalance(cost, p, SumSchedule::CostModel) << ";";
     }
+    std::cout << std::endl;
+}
 
-    // Вычисляем значения f(a) и f(b)
-    double fa = f(a, epsilon);
-    double fb = f(b, epsilon);
+int main(int argc, char* argv[]) {
+    // Балансировка нагрузки: Program4 --balance [N]
+    if (argc >= 2 && std::string(argv[1]) == "--balance") {
+        long long N = argc >= 3 ? std::atoll(argv[2]) : 1000000;
+        if (N <= 0) {
+            std::cerr << "N должно быть положительным" << std::endl;
+            return -1;
+        }
+        compare_schedules(0.0, 10.0, N, 1e-6);
+        return 0;
+    }
 
-    // Формула метода трапеций
-    return h * (fa + 2 * sum + fb) / 2.0;
-}
+    // Точность удвоения сетки: Program4 [tolerance], по умолчанию 1e-8
+    double tolerance = 1e-8;
+    if (argc >= 2) {
+        char* end = nullptr;
+        tolerance = std::strtod(argv[1], &end);
+        if (end == argv[1] || *end != '\0' || !(tolerance > 0)) {
+            std::cerr << "Использование: Program4 [tolerance > 0] | Program4 --balance [N]" << std::endl;
+            return -1;
+        }
+    }
 
-int main() {
     // Параметры задачи
     double a = 0.0; // Левая граница
     double b = 10.0; // Правая граница
-    int N = 1; // Количество отрезков разбиения
+    long long N = 1; // Количество отрезков разбиения
     double epsilon = 1e-6; // Точность для ряда
 
     // Измерение времени для последовательного метода
+    PerfRegion perf_seq("seq");
     auto start_seq = std::chrono::high_resolution_clock::now();
     double result_seq = trapezoidal_rule_seq(a, b, N, epsilon);
     auto end_seq = std::chrono::high_resolution_clock::now();
+    perf_seq.stop();
 
     // Измерение времени для параллельного метода
+    PerfRegion perf_par("par");
     auto start_par = std::chrono::high_resolution_clock::now();
     double result_par = trapezoidal_rule_par(a, b, N, epsilon);
     auto end_par = std::chrono::high_resolution_clock::now();
+    perf_par.stop();
 
     // Расчет времени выполнения
     auto duration_seq = std::chrono::duration_cast<std::chrono::milliseconds>(end_seq - start_seq).count();
@@ -81,10 +163,36 @@ int main() {
     std::cout << "Последовательный метод:" << std::endl;
     std::cout << "  Результат: " << result_seq << std::endl;
     std::cout << "  Время выполнения: " << duration_seq << " мс" << std::endl;
+    // Элемент — одно вычисление f (N + 1 узлов)
+    perf_seq.print(std::cout, N + 1.0);
 
     std::cout << "Параллельный метод:" << std::endl;
     std::cout << "  Результат: " << result_par << std::endl;
     std::cout << "  Время выполнения: " << duration_par << " мс" << std::endl;
+    perf_par.print(std::cout, N + 1.0);
+
+    compare_evaluators(a, b, epsilon);
+
+    // Удвоение числа отрезков с переиспользованием узлов: Ромберг против простых трапеций.
+    // f дорогая: у обоих методов не больше 2^20 отрезков (около миллиона вызовов f)
+    const int max_levels = 20;
+    const std::string not_converged = " (точность не достигнута, предел N = 2^" + std::to_string(max_levels) + ")";
+    auto integrand = [epsilon](double x) { return f(x, epsilon); };
+    auto start_romberg = std::chrono::high_resolution_clock::now();
+    romberg_result romberg = romberg_trapezoidal(a, b, tolerance, integrand, true, max_levels);
+    auto end_romberg = std::chrono::high_resolution_clock::now();
+    romberg_result plain = romberg_trapezoidal(a, b, tolerance, integrand, false, max_levels);
+    auto end_plain = std::chrono::high_resolution_clock::now();
+
+    std::cout << "Удвоение сетки до точности " << tolerance << ":" << std::endl;
+    std::cout << "  Ромберг:  " << romberg.value << ", уровней " << romberg.levels << ", вызовов f "
+              << romberg.evaluations << ", время "
+              << std::chrono::duration<double, std::milli>(end_romberg - start_romberg).count() << " мс"
+              << (romberg.converged ? "" : not_converged) << std::endl;
+    std::cout << "  Трапеции: " << plain.value << ", N = " << (1LL << plain.levels) << ", вызовов f "
+              << plain.evaluations << ", время "
+              << std::chrono::duration<double, std::milli>(end_plain - end_romberg).count() << " мс"
+              << (plain.converged ? "" : not_converged) << std::endl;
 
     return 0;
 }
\ No newline at end of file
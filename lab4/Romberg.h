@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cmath>
+#include <vector>
+
+#include "../common/DeterministicSum.h"
+
+// Метод трапеций с последовательным удвоением числа отрезков.
+//
+// На уровне k отрезок разбит на N = 2^k частей. Узлы уровня k - 1 уже посчитаны,
+// поэтому вычисляются только 2^(k-1) новых середин (параллельно), а
+//   T_k = T_{k-1} / 2 + h_k * sum f(новые середины).
+// При extrapolate = true к последовательности T_k применяется экстраполяция
+// Ричардсона (метод Ромберга), и остановка происходит, когда соседние диагональные
+// элементы таблицы отличаются не больше чем на tolerance. Без экстраполяции
+// остановка — по оценке погрешности трапеций |T_k - T_{k-1}| / 3 <= tolerance.
+
+struct romberg_result {
+    double value = 0.0;
+    double error_estimate = 0.0;
+    int levels = 0;            // число выполненных удвоений
+    long long evaluations = 0; // число вызовов f
+    bool converged = false;
+};
+
+template <typename Integrand>
+romberg_result romberg_trapezoidal(double a, double b, double tolerance, Integrand integrand,
+                                   bool extrapolate = true, int max_levels = 30) {
+    romberg_result result;
+    std::vector<double> previous, current;
+
+    double h = b - a;
+    double trapezoid = h * (integrand(a) + integrand(b)) / 2.0;
+    result.evaluations = 2;
+    previous.push_back(trapezoid);
+
+    for (int k = 1; k <= max_levels; ++k) {
+        long long new_points = 1LL << (k - 1);
+        h /= 2.0;
+        double midpoints = deterministicSum(0, new_points, [&](long long i) {
+            return integrand(a + (2 * i + 1) * h);
+        });
+        result.evaluations += new_points;
+        double previous_trapezoid = trapezoid;
+        trapezoid = trapezoid / 2.0 + h * midpoints;
+
+        // Строка k таблицы Ромберга
+        current.assign(1, trapezoid);
+        if (extrapolate) {
+            double factor = 1.0;
+            for (int j = 1; j <= k; ++j) {
+                factor *= 4.0;
+                current.push_back(current[j - 1] + (current[j - 1] - previous[j - 1]) / (factor - 1.0));
+            }
+            result.value = current.back();
+            result.error_estimate = std::fabs(current.back() - previous.back());
+        }
+        else {
+            result.value = trapezoid;
+            result.error_estimate = std::fabs(trapezoid - previous_trapezoid) / 3.0;
+        }
+        result.levels = k;
+
+        // Несколько первых уровней не проверяем: на грубой сетке оценки случайно совпадают
+        if (k >= 3 && result.error_estimate <= tolerance) {
+            result.converged = true;
+            break;
+        }
+        previous.swap(current);
+    }
+    return result;
+}
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+// Быстрое вычисление f(x) = sum_{n>=1} (-1)^n x^(2n) / ((2n)! * 2n).
+//
+// Это ряд для -Cin(x), где Cin(x) = ∫_0^x (1 - cos t) / t dt = γ + ln|x| - Ci(x).
+// - f_recurrence: тот же ряд, но каждый член получается из предыдущего умножением
+//   на -x^2 / ((2n - 1) * 2n), без pow и tgamma;
+// - f_fast: для |x| <= kSeriesLimit ряд (почти без сокращения знакопеременных членов),
+//   дальше замкнутая форма через Ci(x), которая считается цепной дробью для E1(ix);
+// - f_table: кусочно-кубическая эрмитова интерполяция по таблице на [a, b].
+
+// Граница перехода с ряда на замкнутую форму
+constexpr double kSeriesLimit = 4.0;
+constexpr double kEulerGamma = 0.57721566490153286061;
+
+// Ряд с рекуррентным пересчётом членов; останавливается по тому же правилу, что и f
+inline double f_recurrence(double x, double epsilon) {
+    double x2 = x * x;
+    double sum = 0.0;
+    double power = 1.0; // (-1)^n x^(2n) / (2n)!
+    double term = 1.0;
+    for (int n = 1; std::fabs(term) > epsilon; ++n) {
+        power *= -x2 / ((2.0 * n - 1.0) * (2.0 * n));
+        term = power / (2.0 * n);
+        sum += term;
+    }
+    return sum;
+}
+
+// Интегральный косинус Ci(x) при x > 0 через цепную дробь для E1(ix) (модифицированный метод Ленца).
+// Комплексная арифметика расписана вручную: std::complex делит через медленный __divdc3.
+inline double cosine_integral_cf(double x) {
+    const double tiny = 1e-300;
+    double br = 1.0, bi = x;              // b
+    double cr = 1.0 / tiny, ci = 0.0;     // c
+    double denom = br * br + bi * bi;
+    double dr = br / denom, di = -bi / denom; // d = 1 / b
+    double hr = dr, hi = di;              // h
+    for (int i = 2; i < 200; ++i) {
+        double a = -double(i - 1) * (i - 1);
+        br += 2.0;
+        // d = 1 / (a * d + b)
+        double pr = a * dr + br, pi = a * di + bi;
+        denom = pr * pr + pi * pi;
+        dr = pr / denom;
+        di = -pi / denom;
+        // c = b + a / c
+        denom = cr * cr + ci * ci;
+        cr = br + a * cr / denom;
+        ci = bi - a * ci / denom;
+        // h *= c * d
+        double delr = cr * dr - ci * di, deli = cr * di + ci * dr;
+        double nr = hr * delr - hi * deli;
+        hi = hr * deli + hi * delr;
+        hr = nr;
+        if (std::fabs(delr - 1.0) + std::fabs(deli) < 3e-16) break;
+    }
+    // h *= cos x - i sin x; Ci(x) = -Re(h)
+    return -(hr * std::cos(x) + hi * std::sin(x));
+}
+
+// Значение f(x) с погрешностью не больше epsilon при любом x
+inline double f_fast(double x, double epsilon) {
+    double ax = std::fabs(x); // f чётная
+    if (ax <= kSeriesLimit) return f_recurrence(ax, epsilon);
+    return cosine_integral_cf(ax) - kEulerGamma - std::log(ax);
+}
+
+// Производная f'(x) = (cos x - 1) / x
+inline double f_derivative(double x) {
+    if (std::fabs(x) < 1e-4) return -x / 2.0 + x * x * x / 24.0;
+    return (std::cos(x) - 1.0) / x;
+}
+
+// Таблица для кусочно-кубической эрмитовой интерполяции f на [a, b].
+// f'(x) = -∫_0^1 sin(x t) dt, поэтому |f''''| <= 1/4 и ошибка интерполяции
+// на шаге h не больше h^4 / 384 * 1/4. Шаг выбирается так, чтобы она
+// не превышала epsilon / 2, ещё epsilon / 2 остаётся на значения в узлах.
+class f_table {
+public:
+    f_table(double a, double b, double epsilon) : a_(a) {
+        double h = std::pow(768.0 * epsilon, 0.25);
+        size_t intervals = static_cast<size_t>(std::ceil((b - a) / h));
+        if (intervals == 0) intervals = 1;
+        h_ = (b - a) / intervals;
+        b_ = b;
+        values_.resize(intervals + 1);
+        derivatives_.resize(intervals + 1);
+        fallbackEpsilon_ = epsilon;
+#pragma omp parallel for schedule(static)
+        for (long long k = 0; k <= (long long)intervals; ++k) {
+            double x = a + k * h_;
+            values_[k] = f_fast(x, epsilon / 2.0);
+            derivatives_[k] = f_derivative(x);
+        }
+    }
+
+    double operator()(double x) const {
+        if (x < a_ || x > b_ || h_ <= 0.0) return f_fast(x, fallbackEpsilon_);
+        double position = (x - a_) / h_;
+        size_t k = static_cast<size_t>(position);
+        if (k >= values_.size() - 1) k = values_.size() - 2;
+        double t = position - k;
+        double t2 = t * t, t3 = t2 * t;
+        // Базисные функции Эрмита
+        double h00 = 2.0 * t3 - 3.0 * t2 + 1.0;
+        double h10 = t3 - 2.0 * t2 + t;
+        double h01 = -2.0 * t3 + 3.0 * t2;
+        double h11 = t3 - t2;
+        return h00 * values_[k] + h10 * h_ * derivatives_[k] + h01 * values_[k + 1] + h11 * h_ * derivatives_[k + 1];
+    }
+
+    size_t nodes() const { return values_.size(); }
+
+private:
+    double a_ = 0.0;
+    double b_ = 0.0;
+    double h_ = 0.0;
+    double fallbackEpsilon_ = 0.0;
+    std::vector<double> values_;
+    std::vector<double> derivatives_;
+};
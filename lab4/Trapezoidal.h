@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cmath>
+#include <vector>
+
+#include "../common/BalancedSum.h"
+
+// Исходная функция-ряд f(x, epsilon) и метод трапеций
+
+// Функция для вычисления f(x) с заданной точностью
+inline double f(double x, double epsilon) {
+    double sum = 0.0;
+    double term = 1.0; // Первый член ряда
+    int n = 1;
+
+    while (std::fabs(term) > epsilon) {
+        term = std::pow(-1, n) / (std::tgamma(2 * n + 1) * (2 * n)) * std::pow(x, 2 * n);
+        sum += term;
+        n++;
+    }
+
+    return sum;
+}
+
+// Последовательный метод трапеций
+inline double trapezoidal_rule_seq(double a, double b, long long N, double epsilon) {
+    double h = (b - a) / N;
+    double sum = 0.0;
+
+    // Вычисляем значения f(a) и f(b)
+    double fa = f(a, epsilon);
+    double fb = f(b, epsilon);
+
+    // Суммируем значения f(x_i) для i = 1, ..., N-1
+    for (long long i = 1; i < N; ++i) {
+        double xi = a + i * h;
+        sum += f(xi, epsilon);
+    }
+
+    // Формула метода трапеций
+    return h * (fa + 2 * sum + fb) / 2.0;
+}
+
+// Число членов ряда, которое f(x, epsilon) вычислит до остановки (модель стоимости f):
+// модули членов пересчитываются рекуррентно, без pow и tgamma, поэтому оценка
+// во много раз дешевле самого вычисления f. Для больших |x| растёт примерно как e|x|/2.
+inline int series_terms(double x, double epsilon) {
+    double x2 = x * x;
+    double magnitude = x2 / 4.0; // |член| при n = 1: x^2 / (2! * 2)
+    int n = 1;
+    while (magnitude > epsilon) {
+        magnitude *= x2 / ((2.0 * n + 1.0) * (2.0 * n + 2.0)) * (2.0 * n) / (2.0 * n + 2.0);
+        ++n;
+    }
+    return n;
+}
+
+// Параллельный метод трапеций с OpenMP
+// (сумма складывается фиксированным деревом блоков и не зависит от числа нитей и расписания).
+// Стоимость f растёт с |x|, поэтому по умолчанию листья суммы делятся между нитями по модели
+// series_terms (balancedSum, SumSchedule::CostModel); loads получает занятость и простой нитей.
+inline double trapezoidal_rule_par(double a, double b, long long N, double epsilon,
+                                   SumSchedule schedule = SumSchedule::CostModel,
+                                   std::vector<ThreadLoad>* loads = nullptr) {
+    double h = (b - a) / N;
+    auto term = [&](long long i) {
+        double xi = a + i * h;
+        return f(xi, epsilon);
+    };
+    // Стоимость листа: число членов ряда в его середине на число точек
+    auto leaf_cost = [&](long long begin, long long end) {
+        return (double)series_terms(a + (begin + end) / 2 * h, epsilon) * (end - begin);
+    };
+    double sum = balancedSum(1, N, term, leaf_cost, schedule, loads);
+
+    // Вычисляем значения f(a) и f(b)
+    double fa = f(a, epsilon);
+    double fb = f(b, epsilon);
+
+    // Формула метода трапеций
+    return h * (fa + 2 * sum + fb) / 2.0;
+}
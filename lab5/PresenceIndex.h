@@ -0,0 +1,251 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <omp.h>
+
+// Индекс присутствия символов по корпусу строк для многократных запросов
+// "какие символы набора S отсутствуют в строках [l, r)".
+//
+// Строки группируются в куски (подряд идущие строки общим объёмом от kChunkBytes,
+// строка не короче kChunkBytes — отдельный кусок). Для куска хранится битовая карта
+// присутствия: 256 бит по байтам плюс по 64 бита для второго байта UTF-8 после 0xD0
+// и 0xD1, то есть кириллица U+0400..U+047F различается посимвольно. Над кусками
+// строится дерево отрезков из объединений (OR) карт. Запрос собирает O(log кусков)
+// узлов дерева и просматривает только строки неполных крайних кусков — не больше
+// двух кусков независимо от размера корпуса. Карты кусков строятся параллельно,
+// дописанные строки обновляют последний кусок и путь до корня.
+
+struct CharPresence {
+    uint64_t bytes[4] = {};
+    uint64_t cyrillic[2] = {}; // второй байт 0x80..0xBF после 0xD0 и после 0xD1
+
+    CharPresence& operator|=(const CharPresence& other) {
+        for (int k = 0; k < 4; ++k) bytes[k] |= other.bytes[k];
+        cyrillic[0] |= other.cyrillic[0];
+        cyrillic[1] |= other.cyrillic[1];
+        return *this;
+    }
+
+    // Все символы mask присутствуют
+    bool covers(const CharPresence& mask) const {
+        uint64_t missing = 0;
+        for (int k = 0; k < 4; ++k) missing |= mask.bytes[k] & ~bytes[k];
+        missing |= mask.cyrillic[0] & ~cyrillic[0];
+        missing |= mask.cyrillic[1] & ~cyrillic[1];
+        return missing == 0;
+    }
+};
+
+namespace presence_index {
+
+constexpr size_t kChunkBytes = 16 * 1024;
+
+// Добавление байтов [p, p + n) одной строки в карту.
+// Отметки ставятся в таблицу seen без ветвлений и упаковываются в биты в конце:
+// seen[0..255] — байты, seen[256..383] — вторые байты после 0xD0/0xD1, seen[384] — мусор
+inline void addBytes(const unsigned char* p, size_t n, unsigned char* seen) {
+    for (size_t i = 0; i < n; ++i) {
+        const unsigned c = p[i];
+        seen[c] = 1;
+        const unsigned next = i + 1 < n ? p[i + 1] : 0;
+        const bool pair = (c & 0xFE) == 0xD0 && (next & 0xC0) == 0x80;
+        seen[pair ? 256 + ((c & 1) << 6) + (next & 0x3F) : 384] = 1;
+    }
+}
+
+inline CharPresence pack(const unsigned char* seen) {
+    CharPresence result;
+    for (unsigned c = 0; c < 256; ++c) result.bytes[c >> 6] |= uint64_t(seen[c]) << (c & 63);
+    for (unsigned k = 0; k < 128; ++k) result.cyrillic[k >> 6] |= uint64_t(seen[256 + k]) << (k & 63);
+    return result;
+}
+
+// Карта строк [first, last)
+inline CharPresence scanLines(const std::vector<std::string>& lines, size_t first, size_t last) {
+    unsigned char seen[385] = {};
+    for (size_t i = first; i < last; ++i) {
+        addBytes(reinterpret_cast<const unsigned char*>(lines[i].data()), lines[i].size(), seen);
+    }
+    return pack(seen);
+}
+
+} // namespace presence_index
+
+// Набор символов запроса в UTF-8: ASCII и кириллица U+0400..U+047F
+class CharacterSet {
+public:
+    explicit CharacterSet(const std::string& utf8) {
+        for (size_t i = 0; i < utf8.size();) {
+            const unsigned char c = utf8[i];
+            if ((c & 0xFE) == 0xD0 && i + 1 < utf8.size() && (utf8[i + 1] & 0xC0) == 0x80) {
+                const unsigned k = ((c & 1) << 6) | (utf8[i + 1] & 0x3F);
+                add(utf8.substr(i, 2), mask_.cyrillic[k >> 6], k & 63);
+                i += 2;
+            }
+            else if (c < 0x80) {
+                add(utf8.substr(i, 1), mask_.bytes[c >> 6], c & 63);
+                ++i;
+            }
+            else {
+                throw std::runtime_error("Unsupported character at byte " + std::to_string(i) +
+                                         " (ASCII and Cyrillic only)");
+            }
+        }
+    }
+
+    const CharPresence& mask() const { return mask_; }
+    size_t size() const { return chars_.size(); }
+
+    // Символы набора, которых нет в found, в порядке записи набора
+    std::vector<std::string> missing(const CharPresence& found) const {
+        std::vector<std::string> result;
+        for (const Item& item : chars_) {
+            const uint64_t* words = item.cyrillic ? found.cyrillic : found.bytes;
+            if (!(words[item.word] >> item.bit & 1)) result.push_back(item.text);
+        }
+        return result;
+    }
+
+private:
+    struct Item {
+        std::string text;
+        bool cyrillic;
+        unsigned word;
+        unsigned bit;
+    };
+
+    void add(const std::string& text, uint64_t& word, unsigned bit) {
+        if (word >> bit & 1) return; // повтор
+        word |= uint64_t(1) << bit;
+        const bool cyrillic = text.size() == 2;
+        const uint64_t* base = cyrillic ? mask_.cyrillic : mask_.bytes;
+        chars_.push_back({text, cyrillic, static_cast<unsigned>(&word - base), bit});
+    }
+
+    CharPresence mask_;
+    std::vector<Item> chars_;
+};
+
+class PresenceIndex {
+public:
+    PresenceIndex() = default;
+
+    // Индекс по строкам; карты кусков строятся параллельно
+    explicit PresenceIndex(std::vector<std::string> lines) {
+        append(std::move(lines));
+    }
+
+    const std::vector<std::string>& lines() const { return lines_; }
+    size_t chunkCount() const { return chunkBegin_.size(); }
+
+    // Дописать строки в конец корпуса; обновляются только затронутые куски и пути до корня
+    void append(std::vector<std::string> lines) {
+        using presence_index::kChunkBytes;
+        if (lines.empty()) return;
+        const size_t firstNew = lines_.size();
+        // Строки могут дописаться в последний существующий кусок, он пересчитывается тоже
+        const size_t firstChunk = chunkBegin_.empty() ? 0 : chunkBegin_.size() - 1;
+        for (std::string& line : lines) {
+            if (chunkBegin_.empty() || lastChunkBytes_ >= kChunkBytes || line.size() >= kChunkBytes) {
+                chunkBegin_.push_back(lines_.size());
+                lastChunkBytes_ = 0;
+            }
+            lastChunkBytes_ += line.size() + 1;
+            lines_.push_back(std::move(line));
+        }
+
+        const size_t chunks = chunkBegin_.size();
+        chunkPresence_.resize(chunks);
+        // Карты новых строк по кускам [firstChunk, chunks); в старом куске — только дописанные строки
+#pragma omp parallel for schedule(dynamic, 4)
+        for (long long c = firstChunk; c < (long long)chunks; ++c) {
+            const size_t first = std::max(chunkBegin_[c], firstNew);
+            chunkPresence_[c] |= presence_index::scanLines(lines_, first, chunkEnd(c));
+        }
+
+        if (chunks > leaves_) {
+            rebuildTree();
+        }
+        else {
+            for (size_t c = firstChunk; c < chunks; ++c) updateLeaf(c);
+        }
+    }
+
+    void append(const std::string& line) { append(std::vector<std::string>{line}); }
+
+    // Объединение карт строк [l, r) (r обрезается по числу строк)
+    CharPresence query(size_t l, size_t r, const CharPresence* stopWhenCovered = nullptr) const {
+        CharPresence result;
+        r = std::min(r, lines_.size());
+        if (l >= r) return result;
+        size_t firstChunk = chunkOf(l);
+        size_t lastChunk = chunkOf(r - 1);
+
+        // Неполные крайние куски просматриваются построчно
+        if (firstChunk == lastChunk) {
+            if (l == chunkBegin_[firstChunk] && r == chunkEnd(firstChunk)) return chunkPresence_[firstChunk];
+            return presence_index::scanLines(lines_, l, r);
+        }
+        if (l != chunkBegin_[firstChunk]) result |= presence_index::scanLines(lines_, l, chunkEnd(firstChunk++));
+        if (r != chunkEnd(lastChunk)) {
+            result |= presence_index::scanLines(lines_, chunkBegin_[lastChunk], r);
+        }
+        else {
+            ++lastChunk;
+        }
+        if (stopWhenCovered && result.covers(*stopWhenCovered)) return result;
+
+        // Полные куски [firstChunk, lastChunk): снизу вверх по дереву
+        for (size_t lo = firstChunk + leaves_, hi = lastChunk + leaves_; lo < hi; lo /= 2, hi /= 2) {
+            if (lo & 1) result |= tree_[lo++];
+            if (hi & 1) result |= tree_[--hi];
+        }
+        return result;
+    }
+
+    // Символы набора, отсутствующие в строках [l, r)
+    std::vector<std::string> missing(const CharacterSet& set, size_t l, size_t r) const {
+        return set.missing(query(l, r, &set.mask()));
+    }
+
+private:
+    size_t chunkEnd(size_t c) const { return c + 1 < chunkBegin_.size() ? chunkBegin_[c + 1] : lines_.size(); }
+
+    size_t chunkOf(size_t line) const {
+        return std::upper_bound(chunkBegin_.begin(), chunkBegin_.end(), line) - chunkBegin_.begin() - 1;
+    }
+
+    // Листья [leaves_, 2 * leaves_), число листьев — степень двойки; при нехватке удваивается
+    void rebuildTree() {
+        size_t leaves = std::max<size_t>(1, leaves_);
+        while (leaves < chunkBegin_.size()) leaves *= 2;
+        leaves_ = leaves;
+        tree_.assign(2 * leaves_, CharPresence());
+        std::copy(chunkPresence_.begin(), chunkPresence_.end(), tree_.begin() + leaves_);
+        for (size_t pos = leaves_ - 1; pos >= 1; --pos) {
+            tree_[pos] = tree_[2 * pos];
+            tree_[pos] |= tree_[2 * pos + 1];
+        }
+    }
+
+    void updateLeaf(size_t c) {
+        size_t pos = leaves_ + c;
+        tree_[pos] = chunkPresence_[c];
+        for (pos /= 2; pos >= 1; pos /= 2) {
+            tree_[pos] = tree_[2 * pos];
+            tree_[pos] |= tree_[2 * pos + 1];
+        }
+    }
+
+    std::vector<std::string> lines_;
+    std::vector<size_t> chunkBegin_;         // первая строка каждого куска
+    std::vector<CharPresence> chunkPresence_;
+    size_t lastChunkBytes_ = 0;              // объём последнего куска с переводами строк
+    std::vector<CharPresence> tree_;
+    size_t leaves_ = 0;
+};
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_set>
+#include <vector>
+#include <omp.h>
+
+#if defined(__AVX512BW__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include "../common/MappedFile.h"
+
+// Поиск отсутствующих двухбайтовых символов UTF-8 (кириллица) прямо в байтах файла.
+//
+// Файл отображается в память и делится между нитями на куски, границы которых
+// сдвинуты на начало кодовой точки. Каждая гласная ищется как пара байт
+// (ведущий 0xD0/0xD1 + продолжающий): продолжающий байт никогда не совпадает
+// с ведущим, поэтому совпадение пары возможно только на настоящей кодовой точке.
+// Текст не декодируется в wchar_t, дополнительная память не зависит от размера файла.
+
+class Utf8PairSet {
+public:
+    explicit Utf8PairSet(const std::unordered_set<wchar_t>& chars) {
+        std::vector<wchar_t> sorted(chars.begin(), chars.end());
+        std::sort(sorted.begin(), sorted.end());
+        for (wchar_t c : sorted) {
+            // Поддерживаются только символы U+0080..U+07FF (два байта в UTF-8)
+            if (c < 0x80 || c > 0x7FF || chars_.size() == 64) continue;
+            chars_.push_back(c);
+            lead_.push_back(static_cast<unsigned char>(0xC0 | (c >> 6)));
+            trail_.push_back(static_cast<unsigned char>(0x80 | (c & 0x3F)));
+        }
+        fullMask_ = chars_.size() == 64 ? ~uint64_t(0) : (uint64_t(1) << chars_.size()) - 1;
+    }
+
+    size_t size() const { return chars_.size(); }
+    uint64_t fullMask() const { return fullMask_; }
+    unsigned char lead(size_t k) const { return lead_[k]; }
+    unsigned char trail(size_t k) const { return trail_[k]; }
+
+    std::unordered_set<wchar_t> missing(uint64_t mask) const {
+        std::unordered_set<wchar_t> result;
+        for (size_t k = 0; k < chars_.size(); ++k) {
+            if (!(mask & (uint64_t(1) << k))) result.insert(chars_[k]);
+        }
+        return result;
+    }
+
+private:
+    std::vector<wchar_t> chars_;
+    std::vector<unsigned char> lead_;
+    std::vector<unsigned char> trail_;
+    uint64_t fullMask_ = 0;
+};
+
+namespace utf8_scan {
+
+constexpr size_t kBlockBytes = 16 * 1024;
+
+inline bool isContinuation(unsigned char c) { return (c & 0xC0) == 0x80; }
+
+// Просмотр пар, начинающихся в [p, p + n); байт p[n] (если есть) доступен для чтения,
+// т. к. пара может начинаться в последнем байте блока. hasNext сообщает, есть ли он.
+inline uint64_t scanBlock(const unsigned char* p, size_t n, bool hasNext, const Utf8PairSet& set, uint64_t mask) {
+    // Сколько позиций можно проверить векторно, не выходя за доступные байты
+    size_t available = hasNext ? n + 1 : n;
+    for (size_t k = 0; k < set.size(); ++k) {
+        uint64_t bit = uint64_t(1) << k;
+        if (mask & bit) continue;
+        const unsigned char lead = set.lead(k), trail = set.trail(k);
+        size_t i = 0;
+        bool hit = false;
+#if defined(__AVX512BW__)
+        const __m512i vl = _mm512_set1_epi8(static_cast<char>(lead));
+        const __m512i vt = _mm512_set1_epi8(static_cast<char>(trail));
+        for (; i + 64 < available && i < n && !hit; i += 64) {
+            uint64_t l = _mm512_cmpeq_epi8_mask(_mm512_loadu_si512(p + i), vl);
+            uint64_t t = _mm512_cmpeq_epi8_mask(_mm512_loadu_si512(p + i + 1), vt);
+            hit = (l & t) != 0;
+        }
+#elif defined(__AVX2__)
+        const __m256i vl = _mm256_set1_epi8(static_cast<char>(lead));
+        const __m256i vt = _mm256_set1_epi8(static_cast<char>(trail));
+        for (; i + 32 < available && i < n && !hit; i += 32) {
+            __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i));
+            __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i + 1));
+            hit = _mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(a, vl), _mm256_cmpeq_epi8(b, vt))) != 0;
+        }
+#endif
+        // Скалярный хвост (и весь блок без SIMD); позиции за n не рассматриваются
+        for (; !hit && i < n && i + 1 < available; ++i) {
+            hit = p[i] == lead && p[i + 1] == trail;
+        }
+        if (hit) mask |= bit;
+    }
+    return mask;
+}
+
+} // namespace utf8_scan
+
+// Маска найденных символов в байтах [data, data + size), параллельно по кускам
+inline uint64_t scanUtf8Mask(const char* data, size_t size, const Utf8PairSet& set) {
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data);
+    std::atomic<uint64_t> shared(0);
+
+#pragma omp parallel
+    {
+        const int numThreads = omp_get_num_threads();
+        const int threadId = omp_get_thread_num();
+
+        // Границы куска сдвигаются вперёд до начала кодовой точки
+        auto boundary = [&](int t) {
+            size_t pos = size * t / numThreads;
+            while (pos < size && utf8_scan::isContinuation(bytes[pos])) ++pos;
+            return pos;
+        };
+        size_t begin = boundary(threadId);
+        size_t end = boundary(threadId + 1);
+
+        uint64_t mask = 0;
+        for (size_t offset = begin; offset < end; offset += utf8_scan::kBlockBytes) {
+            uint64_t known = mask | shared.load(std::memory_order_relaxed);
+            if (known == set.fullMask()) break;
+            size_t n = std::min(utf8_scan::kBlockBytes, end - offset);
+            uint64_t updated = utf8_scan::scanBlock(bytes + offset, n, offset + n < size, set, known);
+            if (updated != known) shared.fetch_or(updated, std::memory_order_relaxed);
+            mask = updated;
+        }
+    }
+
+    return shared.load();
+}
+
+// --- Поиск (русский) в UTF-8 файле без декодирования ---
+inline std::unordered_set<wchar_t> findMissingVowelsUtf8File(const std::string& path,
+                                                             const std::unordered_set<wchar_t>& vowels) {
+    MappedFile file(path);
+    file.advise(0, file.size(), MADV_SEQUENTIAL);
+    Utf8PairSet set(vowels);
+    return set.missing(scanUtf8Mask(file.data(), file.size(), set));
+}
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include <mpi.h>
+
+#include "../common/MappedFile.h"
+#include "VowelScanner.h"
+
+// Распределённый поиск гласных: каждый процесс просматривает свою часть корпуса
+// (свои файлы из списка или свой диапазон байт единственного файла) OpenMP-сканером,
+// а маски найденных гласных объединяются через MPI_Allreduce(MPI_BOR).
+//
+// Просмотр идёт порциями по kRoundBytes. Между порциями процесс проверяет
+// неблокирующий MPI_Iallreduce из двух слов: [маска, "есть ещё данные"].
+// Все процессы получают одинаковый результат каждой операции, поэтому одновременно
+// решают остановиться — когда общая маска полная или данных больше ни у кого нет.
+
+namespace vowel_scan_mpi {
+
+constexpr size_t kRoundBytes = 64u << 20;
+
+// Кусок данных процесса: файл и диапазон байт в нём
+struct Shard {
+    std::shared_ptr<MappedFile> file;
+    size_t begin = 0;
+    size_t end = 0;
+};
+
+inline std::vector<Shard> makeShards(const std::vector<std::string>& paths, int rank, int size) {
+    std::vector<Shard> shards;
+    if (paths.size() == 1) {
+        // Один файл делится на диапазоны байт
+        auto file = std::make_shared<MappedFile>(paths[0]);
+        size_t total = file->size();
+        shards.push_back({file, total * rank / size, total * (rank + 1) / size});
+    }
+    else {
+        // Список файлов раздаётся по кругу
+        for (size_t k = rank; k < paths.size(); k += size) {
+            auto file = std::make_shared<MappedFile>(paths[k]);
+            shards.push_back({file, 0, file->size()});
+        }
+    }
+    for (const auto& shard : shards) shard.file->advise(shard.begin, shard.end, MADV_SEQUENTIAL);
+    return shards;
+}
+
+} // namespace vowel_scan_mpi
+
+// Запуск распределённого поиска; вызывается между MPI_Init и MPI_Finalize.
+// Возвращает отсутствующие гласные (одинаково на всех процессах).
+inline std::unordered_set<char> findMissingVowelsMpi(const std::vector<std::string>& paths,
+                                                    const std::unordered_set<char>& vowels) {
+    using namespace vowel_scan_mpi;
+    int rank = 0, size = 1;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    ByteSet set(vowels);
+    std::vector<Shard> shards = makeShards(paths, rank, size);
+    size_t shardIndex = 0;
+    size_t position = shards.empty() ? 0 : shards[0].begin;
+
+    uint64_t mask = 0;
+    uint64_t global = 0;
+    size_t scannedBytes = 0;
+    double scanTime = 0.0, commTime = 0.0;
+    uint64_t send[2], recv[2];
+    MPI_Request request = MPI_REQUEST_NULL;
+    bool pending = false;
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    double start = MPI_Wtime();
+    while (true) {
+        // Пропуск закончившихся кусков
+        while (shardIndex < shards.size() && position >= shards[shardIndex].end) {
+            if (++shardIndex < shards.size()) position = shards[shardIndex].begin;
+        }
+        bool hasMore = shardIndex < shards.size() && (mask | global) != set.fullMask();
+
+        if (hasMore) {
+            const Shard& shard = shards[shardIndex];
+            size_t n = std::min(kRoundBytes, shard.end - position);
+            double t = MPI_Wtime();
+            mask = scanBytesMask(shard.file->data() + position, n, set, mask | global);
+            scanTime += MPI_Wtime() - t;
+            shard.file->advise(position, position + n, MADV_DONTNEED);
+            position += n;
+            scannedBytes += n;
+        }
+
+        double t = MPI_Wtime();
+        if (!pending) {
+            // Признак "есть ещё данные" пересчитывается после просмотра порции
+            bool more = shardIndex < shards.size() &&
+                        (position < shards[shardIndex].end || shardIndex + 1 < shards.size());
+            send[0] = mask;
+            send[1] = more ? 1 : 0;
+            MPI_Iallreduce(send, recv, 2, MPI_UINT64_T, MPI_BOR, MPI_COMM_WORLD, &request);
+            pending = true;
+        }
+        int completed = 0;
+        if (hasMore) {
+            MPI_Test(&request, &completed, MPI_STATUS_IGNORE);
+        }
+        else {
+            // Своих данных нет — ждём остальных
+            MPI_Wait(&request, MPI_STATUS_IGNORE);
+            completed = 1;
+        }
+        commTime += MPI_Wtime() - t;
+
+        if (completed) {
+            pending = false;
+            global = recv[0];
+            if (global == set.fullMask() || recv[1] == 0) break;
+        }
+    }
+    double total = MPI_Wtime() - start;
+
+    // Статистика по процессам
+    double local[4] = {(double)scannedBytes, scanTime, commTime, total};
+    std::vector<double> all(rank == 0 ? 4 * size : 0);
+    MPI_Gather(local, 4, MPI_DOUBLE, all.data(), 4, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+    if (rank == 0) {
+        printf("MPI ranks: %d, OpenMP threads per rank: %d\n", size, omp_get_max_threads());
+        for (int r = 0; r < size; ++r) {
+            double bytes = all[4 * r], scan = all[4 * r + 1];
+            printf("Rank %d: scanned %.3f GB, scan %.4f s (%.2f GB/s), comm %.4f s, total %.4f s\n", r,
+                   bytes / 1e9, scan, scan > 0 ? bytes / 1e9 / scan : 0.0, all[4 * r + 2], all[4 * r + 3]);
+        }
+    }
+
+    return set.missing(global);
+}
@@ -0,0 +1,192 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include <omp.h>
+
+#if defined(__AVX512BW__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+// Поиск отсутствующих символов набора (до 64 символов) с битовой маской.
+//
+// Каждому символу набора соответствует бит маски. Текст проходится блоками:
+// при AVX-512BW/AVX2 блок сравнивается сразу с каждым ещё не найденным символом,
+// иначе используется таблица из 256 элементов (байт -> бит). Нить копит свою
+// 64-битную маску и дописывает новые символы в общую атомарную маску; как только
+// общая маска полная, все нити прекращают просмотр на ближайшей границе блока.
+
+class ByteSet {
+public:
+    explicit ByteSet(const std::unordered_set<char>& chars) {
+        std::fill(std::begin(bitOf_), std::end(bitOf_), 0);
+        // Фиксированный порядок символов, чтобы номера битов не зависели от хеш-таблицы
+        std::vector<unsigned char> sorted;
+        for (char c : chars) sorted.push_back(static_cast<unsigned char>(c));
+        std::sort(sorted.begin(), sorted.end());
+        if (sorted.size() > 64) sorted.resize(64);
+        for (size_t k = 0; k < sorted.size(); ++k) {
+            bitOf_[sorted[k]] = uint64_t(1) << k;
+        }
+        chars_ = sorted;
+        fullMask_ = sorted.size() == 64 ? ~uint64_t(0) : (uint64_t(1) << sorted.size()) - 1;
+    }
+
+    uint64_t bitOf(unsigned char c) const { return bitOf_[c]; }
+    uint64_t fullMask() const { return fullMask_; }
+    size_t size() const { return chars_.size(); }
+    unsigned char charAt(size_t k) const { return chars_[k]; }
+
+    // Символы набора, бит которых не выставлен в mask
+    std::unordered_set<char> missing(uint64_t mask) const {
+        std::unordered_set<char> result;
+        for (size_t k = 0; k < chars_.size(); ++k) {
+            if (!(mask & (uint64_t(1) << k))) result.insert(static_cast<char>(chars_[k]));
+        }
+        return result;
+    }
+
+private:
+    uint64_t bitOf_[256];
+    std::vector<unsigned char> chars_;
+    uint64_t fullMask_ = 0;
+};
+
+namespace vowel_scan {
+
+// Размер блока, после которого проверяется общая маска (досрочное завершение)
+constexpr size_t kBlockBytes = 16 * 1024;
+// При большем числе символов сравнения по одному дороже таблицы
+constexpr size_t kMaxSimdChars = 16;
+
+// Табличный просмотр [p, p + n)
+inline uint64_t scanTable(const unsigned char* p, size_t n, const ByteSet& set, uint64_t mask) {
+    uint64_t local = 0;
+    for (size_t i = 0; i < n; ++i) local |= set.bitOf(p[i]);
+    return mask | local;
+}
+
+#if defined(__AVX512BW__) || defined(__AVX2__)
+// SIMD-просмотр [p, p + n): сравнение с каждым ещё не найденным символом
+inline uint64_t scanSimd(const unsigned char* p, size_t n, const ByteSet& set, uint64_t mask) {
+#if defined(__AVX512BW__)
+    constexpr size_t kWidth = 64;
+#else
+    constexpr size_t kWidth = 32;
+#endif
+    size_t i = 0;
+    for (size_t k = 0; k < set.size(); ++k) {
+        uint64_t bit = uint64_t(1) << k;
+        if (mask & bit) continue;
+#if defined(__AVX512BW__)
+        __m512i needle = _mm512_set1_epi8(static_cast<char>(set.charAt(k)));
+        uint64_t hits = 0;
+        for (i = 0; i + kWidth <= n && !hits; i += kWidth) {
+            hits = _mm512_cmpeq_epi8_mask(_mm512_loadu_si512(p + i), needle);
+        }
+#else
+        __m256i needle = _mm256_set1_epi8(static_cast<char>(set.charAt(k)));
+        uint32_t hits = 0;
+        for (i = 0; i + kWidth <= n && !hits; i += kWidth) {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i));
+            hits = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, needle)));
+        }
+#endif
+        if (hits) {
+            mask |= bit;
+            continue;
+        }
+        // Хвост короче вектора
+        for (i = n - n % kWidth; i < n; ++i) {
+            if (p[i] == set.charAt(k)) {
+                mask |= bit;
+                break;
+            }
+        }
+    }
+    return mask;
+}
+#endif
+
+// Просмотр одного блока выбранным способом
+inline uint64_t scanBlock(const unsigned char* p, size_t n, const ByteSet& set, uint64_t mask) {
+#if defined(__AVX512BW__) || defined(__AVX2__)
+    if (set.size() <= kMaxSimdChars) return scanSimd(p, n, set, mask);
+#endif
+    return scanTable(p, n, set, mask);
+}
+
+// Просмотр строки блоками. shared — общая для всех нитей маска найденных символов:
+// символы, уже найденные другими нитями, не ищутся, а при полной маске просмотр прекращается.
+inline uint64_t scanRange(const char* data, size_t size, const ByteSet& set, uint64_t mask,
+                          std::atomic<uint64_t>& shared) {
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(data);
+    for (size_t offset = 0; offset < size; offset += kBlockBytes) {
+        uint64_t known = mask | shared.load(std::memory_order_relaxed);
+        if (known == set.fullMask()) return known;
+        uint64_t updated = scanBlock(p + offset, std::min(kBlockBytes, size - offset), set, known);
+        if (updated != known) {
+            // Новые символы бывают не чаще 64 раз, поэтому атомарная операция здесь дешёвая
+            shared.fetch_or(updated, std::memory_order_relaxed);
+        }
+        mask = updated;
+    }
+    return mask;
+}
+
+// Название используемого способа просмотра
+inline const char* kernelName(const ByteSet& set) {
+#if defined(__AVX512BW__)
+    if (set.size() <= kMaxSimdChars) return "AVX-512BW";
+#elif defined(__AVX2__)
+    if (set.size() <= kMaxSimdChars) return "AVX2";
+#endif
+    (void)set;
+    return "table";
+}
+
+} // namespace vowel_scan
+
+// Маска найденных символов набора в массиве строк; строки делятся между нитями динамически
+inline uint64_t scanVowelMask(const std::vector<std::string>& text, const ByteSet& set) {
+    std::atomic<uint64_t> shared(0);
+    uint64_t found = 0;
+
+#pragma omp parallel for schedule(dynamic, 16) reduction(|:found)
+    for (long long i = 0; i < (long long)text.size(); ++i) {
+        // Все символы уже найдены — оставшиеся строки пропускаются
+        if (shared.load(std::memory_order_relaxed) == set.fullMask()) continue;
+        found |= vowel_scan::scanRange(text[i].data(), text[i].size(), set, found, shared);
+    }
+
+    return found | shared.load();
+}
+
+// Маска найденных символов в байтах [data, data + size); known — уже известные символы.
+// Блоки делятся между нитями статически, досрочный выход — как в scanVowelMask.
+inline uint64_t scanBytesMask(const char* data, size_t size, const ByteSet& set, uint64_t known = 0) {
+    std::atomic<uint64_t> shared(known);
+    const long long blocks = (size + vowel_scan::kBlockBytes - 1) / vowel_scan::kBlockBytes;
+
+#pragma omp parallel for schedule(static)
+    for (long long b = 0; b < blocks; ++b) {
+        if (shared.load(std::memory_order_relaxed) == set.fullMask()) continue;
+        size_t offset = b * vowel_scan::kBlockBytes;
+        vowel_scan::scanRange(data + offset, std::min(vowel_scan::kBlockBytes, size - offset), set, 0, shared);
+    }
+
+    return shared.load();
+}
+
+// --- Параллельный поиск (английский) через битовую маску ---
+inline std::unordered_set<char> findMissingVowelsBitmask(
+        const std::vector<std::string>& text, const std::unordered_set<char>& vowels)
+{
+    ByteSet set(vowels);
+    return set.missing(scanVowelMask(text, set));
+}
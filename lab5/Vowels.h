@@ -0,0 +1,125 @@
+#pragma once
+
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include <omp.h>
+
+#include "../common/Trace.h"
+
+// Наборы гласных и исходные версии поиска отсутствующих гласных
+
+// --- Английские гласные ---
+inline std::unordered_set<char> getEnglishVowels() {
+    return {'A','E','I','O','U','a','e','i','o','u'};
+}
+
+// --- Русские гласные ---
+inline std::unordered_set<wchar_t> getRussianVowels() {
+    return {L'А',L'Е',L'Ё',L'И',L'О',L'У',L'Ы',L'Э',L'Ю',L'Я',
+            L'а',L'е',L'ё',L'и',L'о',L'у',L'ы',L'э',L'ю',L'я'};
+}
+
+// --- Последовательный поиск (английский) ---
+inline std::unordered_set<char> findMissingVowelsSequential(
+        const std::vector<std::string>& text, const std::unordered_set<char>& vowels)
+{
+    std::unordered_set<char> found;
+
+    for (const auto& line : text) {
+        for (char c : line) {
+            if (vowels.count(c)) {
+                found.insert(c);
+            }
+        }
+    }
+
+    std::unordered_set<char> missing;
+    for (char v : vowels) {
+        if (!found.count(v)) missing.insert(v);
+    }
+    return missing;
+}
+
+// --- Параллельный поиск (английский) ---
+inline std::unordered_set<char> findMissingVowelsParallel(
+        const std::vector<std::string>& text, const std::unordered_set<char>& vowels)
+{
+    std::vector<std::unordered_set<char>> local_found(omp_get_max_threads());
+
+    // Доля каждой нити отмечается в трассе (TRACE_FILE), чтобы был виден дисбаланс local_found
+    #pragma omp parallel
+    {
+        TraceScope work("local_found");
+        int tid = omp_get_thread_num();
+        #pragma omp for nowait
+        for (int i = 0; i < (int)text.size(); ++i) {
+            for (char c : text[i]) {
+                if (vowels.count(c)) {
+                    local_found[tid].insert(c);
+                }
+            }
+        }
+    }
+
+    std::unordered_set<char> found;
+    for (const auto& s : local_found) found.insert(s.begin(), s.end());
+
+    std::unordered_set<char> missing;
+    for (char v : vowels) {
+        if (!found.count(v)) missing.insert(v);
+    }
+    return missing;
+}
+
+// --- Последовательный поиск (русский) ---
+inline std::unordered_set<wchar_t> findMissingVowelsSequentialW(
+        const std::vector<std::wstring>& text, const std::unordered_set<wchar_t>& vowels)
+{
+    std::unordered_set<wchar_t> found;
+
+    for (const auto& line : text) {
+        for (wchar_t c : line) {
+            if (vowels.count(c)) {
+                found.insert(c);
+            }
+        }
+    }
+
+    std::unordered_set<wchar_t> missing;
+    for (wchar_t v : vowels) {
+        if (!found.count(v)) missing.insert(v);
+    }
+    return missing;
+}
+
+// --- Параллельный поиск (русский) ---
+inline std::unordered_set<wchar_t> findMissingVowelsParallelW(
+        const std::vector<std::wstring>& text, const std::unordered_set<wchar_t>& vowels)
+{
+    std::vector<std::unordered_set<wchar_t>> local_found(omp_get_max_threads());
+
+    // Доля каждой нити отмечается в трассе (TRACE_FILE), чтобы был виден дисбаланс local_found
+    #pragma omp parallel
+    {
+        TraceScope work("local_found");
+        int tid = omp_get_thread_num();
+        #pragma omp for nowait
+        for (int i = 0; i < (int)text.size(); ++i) {
+            for (wchar_t c : text[i]) {
+                if (vowels.count(c)) {
+                    local_found[tid].insert(c);
+                }
+            }
+        }
+    }
+
+    std::unordered_set<wchar_t> found;
+    for (const auto& s : local_found) found.insert(s.begin(), s.end());
+
+    std::unordered_set<wchar_t> missing;
+    for (wchar_t v : vowels) {
+        if (!found.count(v)) missing.insert(v);
+    }
+    return missing;
+}
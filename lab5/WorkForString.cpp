@@ -5,113 +5,18 @@
 #include <chrono>
 #include <omp.h>
 #include <locale>
+#include <cstdlib>
+#include <cstdint>
+#include <sstream>
+#include <fstream>
 
-using namespace std;
-
-// --- Английские гласные ---
-unordered_set<char> getEnglishVowels() {
-    return {'A','E','I','O','U','a','e','i','o','u'};
-}
-
-// --- Русские гласные ---
-unordered_set<wchar_t> getRussianVowels() {
-    return {L'А',L'Е',L'Ё',L'И',L'О',L'У',L'Ы',L'Э',L'Ю',L'Я',
-            L'а',L'е',L'ё',L'и',L'о',L'у',L'ы',L'э',L'ю',L'я'};
-}
-
-// --- Последовательный поиск (английский) ---
-unordered_set<char> findMissingVowelsSequential(
-        const vector<string>& text, const unordered_set<char>& vowels)
-{
-    unordered_set<char> found;
-
-    for (const auto& line : text) {
-        for (char c : line) {
-            if (vowels.count(c)) {
-                found.insert(c);
-            }
-        }
-    }
-
-    unordered_set<char> missing;
-    for (char v : vowels) {
-        if (!found.count(v)) missing.insert(v);
-    }
-    return missing;
-}
-
-// --- Параллельный поиск (английский) ---
-unordered_set<char> findMissingVowelsParallel(
-        const vector<string>& text, const unordered_set<char>& vowels)
-{
-    vector<unordered_set<char>> local_found(omp_get_max_threads());
-
-    #pragma omp parallel for
-    for (int i = 0; i < (int)text.size(); ++i) {
-        int tid = omp_get_thread_num();
-        for (char c : text[i]) {
-            if (vowels.count(c)) {
-                local_found[tid].insert(c);
-            }
-        }
-    }
-
-    unordered_set<char> found;
-    for (const auto& s : local_found) found.insert(s.begin(), s.end());
-
-    unordered_set<char> missing;
-    for (char v : vowels) {
-        if (!found.count(v)) missing.insert(v);
-    }
-    return missing;
-}
-
-// --- Последовательный поиск (русский) ---
-unordered_set<wchar_t> findMissingVowelsSequentialW(
-        const vector<wstring>& text, const unordered_set<wchar_t>& vowels)
-{
-    unordered_set<wchar_t> found;
-
-    for (const auto& line : text) {
-        for (wchar_t c : line) {
-            if (vowels.count(c)) {
-                found.insert(c);
-            }
-        }
-    }
+#include "PresenceIndex.h"
+#include "Utf8Scanner.h"
+#include "VowelScanMpi.h"
+#include "VowelScanner.h"
+#include "Vowels.h"
 
-    unordered_set<wchar_t> missing;
-    for (wchar_t v : vowels) {
-        if (!found.count(v)) missing.insert(v);
-    }
-    return missing;
-}
-
-// --- Параллельный поиск (русский) ---
-unordered_set<wchar_t> findMissingVowelsParallelW(
-        const vector<wstring>& text, const unordered_set<wchar_t>& vowels)
-{
-    vector<unordered_set<wchar_t>> local_found(omp_get_max_threads());
-
-    #pragma omp parallel for
-    for (int i = 0; i < (int)text.size(); ++i) {
-        int tid = omp_get_thread_num();
-        for (wchar_t c : text[i]) {
-            if (vowels.count(c)) {
-                local_found[tid].insert(c);
-            }
-        }
-    }
-
-    unordered_set<wchar_t> found;
-    for (const auto& s : local_found) found.insert(s.begin(), s.end());
-
-    unordered_set<wchar_t> missing;
-    for (wchar_t v : vowels) {
-        if (!found.count(v)) missing.insert(v);
-    }
-    return missing;
-}
+using namespace std;
 
 // --- Вывод для английских гласных ---
 void printResult(const unordered_set<char>& missing, const string& lang) {
@@ -147,15 +52,26 @@ void testEnglishVowels(const vector<string>& text) {
     auto missing_par = findMissingVowelsParallel(text, vowels);
     auto end_par = chrono::high_resolution_clock::now();
 
+    auto start_mask = chrono::high_resolution_clock::now();
+    auto missing_mask = findMissingVowelsBitmask(text, vowels);
+    auto end_mask = chrono::high_resolution_clock::now();
+
     printResult(missing_seq, "English");
 
     chrono::duration<double> dur_seq = end_seq - start_seq;
     chrono::duration<double> dur_par = end_par - start_par;
+    chrono::duration<double> dur_mask = end_mask - start_mask;
 
-    cout << "⏱ Sequential: " << dur_seq.count() << " s\n";
-    cout << "⏱ Parallel:   " << dur_par.count() << " s\n";
+    size_t bytes = 0;
+    for (const auto& line : text) bytes += line.size();
+    double gb = bytes / 1e9;
 
-    if (missing_seq == missing_par) {
+    cout << "⏱ Sequential: " << dur_seq.count() << " s (" << gb / dur_seq.count() << " GB/s)\n";
+    cout << "⏱ Parallel:   " << dur_par.count() << " s (" << gb / dur_par.count() << " GB/s)\n";
+    cout << "⏱ Bitmask (" << vowel_scan::kernelName(ByteSet(vowels)) << "): " << dur_mask.count()
+         << " s (" << gb / dur_mask.count() << " GB/s)\n";
+
+    if (missing_seq == missing_par && missing_seq == missing_mask) {
         cout << "✅ Results match.\n";
     } else {
         cout << "❌ Results differ!\n";
@@ -189,10 +105,179 @@ void testRussianVowels(const vector<wstring>& text) {
     }
 }
 
-int main() {
+// Декодирование UTF-8 в строки wstring (только для сверки результатов на небольших файлах)
+vector<wstring> decodeUtf8Lines(const char* data, size_t size) {
+    vector<wstring> lines(1);
+    for (size_t i = 0; i < size;) {
+        unsigned char c = data[i];
+        wchar_t code = c;
+        size_t length = 1;
+        if (c >= 0xF0) { code = c & 0x07; length = 4; }
+        else if (c >= 0xE0) { code = c & 0x0F; length = 3; }
+        else if (c >= 0xC0) { code = c & 0x1F; length = 2; }
+        for (size_t k = 1; k < length && i + k < size; ++k) code = (code << 6) | (data[i + k] & 0x3F);
+        i += length;
+        if (code == L'\n') lines.emplace_back();
+        else lines.back() += code;
+    }
+    return lines;
+}
+
+// --- Тест для русского текста из UTF-8 файла без декодирования ---
+void testRussianVowelsUtf8File(const string& path) {
+    auto vowels = getRussianVowels();
+
+    auto start_utf8 = chrono::high_resolution_clock::now();
+    auto missing_utf8 = findMissingVowelsUtf8File(path, vowels);
+    auto end_utf8 = chrono::high_resolution_clock::now();
+
+    printResultW(missing_utf8, L"Русский, UTF-8");
+
+    MappedFile file(path);
+    chrono::duration<double> dur_utf8 = end_utf8 - start_utf8;
+    wcout << L"⏱ UTF-8 без декодирования: " << dur_utf8.count() << L" секунд ("
+          << file.size() / 1e9 / dur_utf8.count() << L" ГБ/с)\n";
+
+    // Сверка с исходным алгоритмом на декодированном тексте, пока он помещается в память без труда
+    if (file.size() <= (256u << 20)) {
+        auto start_decode = chrono::high_resolution_clock::now();
+        vector<wstring> text = decodeUtf8Lines(file.data(), file.size());
+        auto missing_par = findMissingVowelsParallelW(text, vowels);
+        auto end_decode = chrono::high_resolution_clock::now();
+        chrono::duration<double> dur_decode = end_decode - start_decode;
+        wcout << L"⏱ Декодирование + параллельно: " << dur_decode.count() << L" секунд\n";
+        if (missing_par == missing_utf8) {
+            wcout << L"✅ Результаты совпадают.\n";
+        } else {
+            wcout << L"❌ Результаты отличаются!\n";
+        }
+    }
+}
+
+// Синтетический английский текст примерно из megabytes МБ без буквы 'u',
+// чтобы просмотр не завершался досрочно и замер показывал пропускную способность
+vector<string> makeLargeEnglishText(size_t megabytes) {
+    const string alphabet = "abcdefghijklmnopqrstvwxyzABCDEFGHIJKLMNOPQRSTVWXYZ ,.";
+    const size_t lineLength = 1 << 20;
+    vector<string> text(max<size_t>(1, megabytes));
+    #pragma omp parallel for
+    for (int i = 0; i < (int)text.size(); ++i) {
+        string& line = text[i];
+        line.resize(lineLength);
+        unsigned state = i * 2654435761u + 1;
+        for (size_t k = 0; k < lineLength; ++k) {
+            state = state * 1664525u + 1013904223u;
+            line[k] = alphabet[(state >> 16) % alphabet.size()];
+        }
+    }
+    return text;
+}
+
+// Индекс присутствия символов по строкам файла и запросы из stdin:
+//   "символы [l r]" — отсутствующие в строках [l, r) символы набора (по умолчанию во всём файле),
+//   "+текст"        — дописать строку в корпус
+int runIndexMode(const string& path) {
+    ifstream file(path);
+    if (!file) {
+        cerr << "Cannot open file: " << path << endl;
+        return -1;
+    }
+    vector<string> lines;
+    for (string line; getline(file, line);) lines.push_back(move(line));
+
+    size_t bytes = 0;
+    for (const auto& line : lines) bytes += line.size() + 1;
+    auto start = chrono::high_resolution_clock::now();
+    PresenceIndex index(move(lines));
+    chrono::duration<double> build = chrono::high_resolution_clock::now() - start;
+    cout << "Indexed " << index.lines().size() << " lines (" << bytes << " bytes) in " << index.chunkCount()
+         << " chunks, " << build.count() << " s" << endl;
+
+    for (string query; getline(cin, query);) {
+        if (query.empty() || query[0] == '#') continue;
+        if (query[0] == '+') {
+            index.append(query.substr(1));
+            cout << "Appended line " << index.lines().size() - 1 << ", chunks: " << index.chunkCount() << endl;
+            continue;
+        }
+        try {
+            istringstream fields(query);
+            string chars;
+            size_t l = 0, r = SIZE_MAX;
+            fields >> chars >> l >> r;
+            CharacterSet set(chars);
+
+            start = chrono::high_resolution_clock::now();
+            vector<string> missing = index.missing(set, l, r);
+            chrono::duration<double> indexed = chrono::high_resolution_clock::now() - start;
+
+            // Сверка с полным просмотром диапазона
+            start = chrono::high_resolution_clock::now();
+            vector<string> rescanned =
+                set.missing(presence_index::scanLines(index.lines(), min(l, index.lines().size()),
+                                                      min(r, index.lines().size())));
+            chrono::duration<double> rescan = chrono::high_resolution_clock::now() - start;
+
+            cout << "Missing:";
+            for (const auto& c : missing) cout << ' ' << c;
+            if (missing.empty()) cout << " none";
+            cout << " (index " << indexed.count() * 1e6 << " us, rescan " << rescan.count() * 1e6 << " us"
+                 << (missing == rescanned ? "" : ", MISMATCH") << ")" << endl;
+        }
+        catch (const exception& e) {
+            cout << "error: " << e.what() << endl;
+        }
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
     // Устанавливаем локаль для корректного вывода русских символов
     setlocale(LC_ALL, "");
 
+    // Замер на большом синтетическом тексте: Program5 --bench <мегабайты>
+    if (argc >= 3 && string(argv[1]) == "--bench") {
+        testEnglishVowels(makeLargeEnglishText(atoll(argv[2])));
+        return 0;
+    }
+
+    // Распределённый просмотр корпуса: mpirun -np N Program5 --mpi <файл> [<файл> ...]
+    // (один файл делится между процессами по байтам, несколько — раздаются по кругу)
+    if (argc >= 3 && string(argv[1]) == "--mpi") {
+        vector<string> paths(argv + 2, argv + argc);
+        int provided = 0;
+        MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED, &provided);
+        int rank = 0;
+        MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+        try {
+            auto missing = findMissingVowelsMpi(paths, getEnglishVowels());
+            if (rank == 0) printResult(missing, "English, MPI");
+        }
+        catch (const exception& e) {
+            cerr << "Rank " << rank << ": " << e.what() << endl;
+            MPI_Abort(MPI_COMM_WORLD, -1);
+        }
+        MPI_Finalize();
+        return 0;
+    }
+
+    // Запросы по индексу присутствия символов: Program5 --index <файл> < запросы
+    if (argc >= 3 && string(argv[1]) == "--index") {
+        return runIndexMode(argv[2]);
+    }
+
+    // Русский текст из UTF-8 файла: Program5 --utf8 <файл>
+    if (argc >= 3 && string(argv[1]) == "--utf8") {
+        try {
+            testRussianVowelsUtf8File(argv[2]);
+        }
+        catch (const exception& e) {
+            cerr << e.what() << endl;
+            return -1;
+        }
+        return 0;
+    }
+
     // Пример английского текста
     vector<string> englishText = {
         "The quick brown fox jumps over the lazy dog",
@@ -0,0 +1,58 @@
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include <algorithm>
+#include <omp.h>
+
+#include "../common/Matrix.h"
+#include "../common/MatrixFile.h"
+#include "../common/MatrixGenerator.h"
+
+using namespace std;
+
+// Генератор тестовых файлов матриц в двоичном формате (см. common/MatrixFile.h).
+// Матрица генерируется порциями строк, поэтому файл может быть больше оперативной памяти.
+// Значения совпадают с generateRowBlock: одна и та же строка всегда получает одни и те же числа.
+int main(int argc, char* argv[]) {
+    if (argc < 4) {
+        cerr << "Usage: " << argv[0] << " <output> <rows> <cols> [modulus=1000]" << endl;
+        return -1;
+    }
+    string path = argv[1];
+    long long rows = atoll(argv[2]);
+    long long cols = atoll(argv[3]);
+    int modulus = argc >= 5 ? atoi(argv[4]) : 1000;
+    if (rows <= 0 || cols <= 0 || modulus <= 0) {
+        cerr << "Rows, cols and modulus must be positive." << endl;
+        return -1;
+    }
+
+    auto start = chrono::high_resolution_clock::now();
+    try {
+        // Строки в файле выравниваем так же, как в Matrix, чтобы SIMD-загрузки были выровнены
+        MatrixFileWriter writer(path, MatrixElementType::Int32, rows, cols, Matrix<int>::paddedStride(cols));
+
+        // Порция около 64 МБ
+        long long chunkRows = max<long long>(1, (64LL << 20) / (cols * (long long)sizeof(int)));
+        Matrix<int> chunk(min(chunkRows, rows), cols);
+        for (long long begin = 0; begin < rows; begin += chunkRows) {
+            long long count = min(chunkRows, rows - begin);
+            if (count != (long long)chunk.rows()) chunk = Matrix<int>(count, cols);
+            generateRowBlock(chunk, begin, modulus);
+            for (long long i = 0; i < count; ++i) writer.writeRow(chunk.row(i));
+        }
+        writer.close();
+    }
+    catch (const exception& e) {
+        cerr << e.what() << endl;
+        return -1;
+    }
+    auto end = chrono::high_resolution_clock::now();
+
+    double gib = (double)rows * Matrix<int>::paddedStride(cols) * sizeof(int) / (1 << 30);
+    cout << "Written " << rows << " x " << cols << " matrix (" << gib << " GiB) to " << path
+         << " in " << chrono::duration<double>(end - start).count() << " s" << endl;
+    return 0;
+}